@@ -206,151 +206,33 @@ namespace Gala {
             workspace_manager.cleanup ();
         }
 
-        // Code ported from KWin present windows effect
-        // https://projects.kde.org/projects/kde/kde-workspace/repository/revisions/master/entry/kwin/effects/presentwindows/presentwindows.cpp
-
-        // constants, mainly for natural expo
-        const int GAPS = 10;
-        const int MAX_TRANSLATIONS = 100000;
-        const int ACCURACY = 20;
-
-        // some math utilities
-        static int squared_distance (Gdk.Point a, Gdk.Point b) {
-            var k1 = b.x - a.x;
-            var k2 = b.y - a.y;
-
-            return k1 * k1 + k2 * k2;
-        }
-
-        static Meta.Rectangle rect_adjusted (Meta.Rectangle rect, int dx1, int dy1, int dx2, int dy2) {
-            return {rect.x + dx1, rect.y + dy1, rect.width + (-dx1 + dx2), rect.height + (-dy1 + dy2)};
-        }
-
-        static Gdk.Point rect_center (Meta.Rectangle rect) {
-            return {rect.x + rect.width / 2, rect.y + rect.height / 2};
-        }
-
         public struct TilableWindow {
             Meta.Rectangle rect;
             void *id;
         }
 
-        public static List<TilableWindow?> calculate_grid_placement (Meta.Rectangle area, List<TilableWindow?> windows) {
-            uint window_count = windows.length ();
-            int columns = (int)Math.ceil (Math.sqrt (window_count));
-            int rows = (int)Math.ceil (window_count / (double)columns);
-
-            // Assign slots
-            int slot_width = area.width / columns;
-            int slot_height = area.height / rows;
-
-            TilableWindow?[] taken_slots = {};
-            taken_slots.resize (rows * columns);
-
-            // precalculate all slot centers
-            Gdk.Point[] slot_centers = {};
-            slot_centers.resize (rows * columns);
-            for (int x = 0; x < columns; x++) {
-                for (int y = 0; y < rows; y++) {
-                    slot_centers[x + y * columns] = {
-                        area.x + slot_width * x + slot_width / 2,
-                        area.y + slot_height * y + slot_height / 2
-                    };
-                }
-            }
-
-            // Assign each window to the closest available slot
-            var tmplist = windows.copy ();
-            while (tmplist.length () > 0) {
-                unowned List<unowned TilableWindow?> link = tmplist.nth (0);
-                var window = link.data;
-                var rect = window.rect;
-
-                var slot_candidate = -1;
-                var slot_candidate_distance = int.MAX;
-                var pos = rect_center (rect);
-
-                // all slots
-                for (int i = 0; i < columns * rows; i++) {
-                    if (i > window_count - 1)
-                        break;
-
-                    var dist = squared_distance (pos, slot_centers[i]);
-
-                    if (dist < slot_candidate_distance) {
-                        // window is interested in this slot
-                        var occupier = taken_slots[i];
-                        if (occupier == window)
-                            continue;
-
-                        if (occupier == null || dist < squared_distance (rect_center (occupier.rect), slot_centers[i])) {
-                            // either nobody lives here, or we're better - takeover the slot if it's our best
-                            slot_candidate = i;
-                            slot_candidate_distance = dist;
-                        }
-                    }
-                }
-
-                if (slot_candidate == -1)
-                    continue;
-
-                if (taken_slots[slot_candidate] != null)
-                    tmplist.prepend (taken_slots[slot_candidate]);
+        public static List<TilableWindow?> calculate_grid_placement (Meta.Rectangle area, List<TilableWindow?> windows, bool natural = false) {
+            var window_rects = new WindowLayout.Rect[windows.length ()];
+            var ids = new void*[window_rects.length];
 
-                tmplist.remove_link (link);
-                taken_slots[slot_candidate] = window;
+            var i = 0;
+            foreach (var window in windows) {
+                window_rects[i] = { window.rect.x, window.rect.y, window.rect.width, window.rect.height };
+                ids[i] = window.id;
+                i++;
             }
 
-            var result = new List<TilableWindow?> ();
-
-            // see how many windows we have on the last row
-            int left_over = (int)window_count - columns * (rows - 1);
-
-            for (int slot = 0; slot < columns * rows; slot++) {
-                var window = taken_slots[slot];
-                // some slots might be empty
-                if (window == null)
-                    continue;
-
-                var rect = window.rect;
-
-                // Work out where the slot is
-                Meta.Rectangle target = {area.x + (slot % columns) * slot_width,
-                                         area.y + (slot / columns) * slot_height,
-                                         slot_width,
-                                         slot_height};
-                target = rect_adjusted (target, 10, 10, -10, -10);
-
-                float scale;
-                if (target.width / (double)rect.width < target.height / (double)rect.height) {
-                    // Center vertically
-                    scale = target.width / (float)rect.width;
-                    target.y += (target.height - (int)(rect.height * scale)) / 2;
-                    target.height = (int)Math.floorf (rect.height * scale);
-                } else {
-                    // Center horizontally
-                    scale = target.height / (float)rect.height;
-                    target.x += (target.width - (int)(rect.width * scale)) / 2;
-                    target.width = (int)Math.floorf (rect.width * scale);
-                }
+            WindowLayout.Rect layout_area = { area.x, area.y, area.width, area.height };
+            var targets = natural
+                ? WindowLayout.calculate_natural (layout_area, window_rects)
+                : WindowLayout.calculate_grid (layout_area, window_rects);
 
-                // Don't scale the windows too much
-                if (scale > 1.0) {
-                    scale = 1.0f;
-                    target = {rect_center (target).x - (int)Math.floorf (rect.width * scale) / 2,
-                              rect_center (target).y - (int)Math.floorf (rect.height * scale) / 2,
-                              (int)Math.floorf (scale * rect.width),
-                              (int)Math.floorf (scale * rect.height)};
-                }
-
-                // put the last row in the center, if necessary
-                if (left_over != columns && slot >= columns * (rows - 1))
-                    target.x += (columns - left_over) * slot_width / 2;
-
-                result.prepend ({ target, window.id });
+            var result = new List<TilableWindow?> ();
+            for (i = targets.length - 1; i >= 0; i--) {
+                Meta.Rectangle target = { targets[i].x, targets[i].y, targets[i].width, targets[i].height };
+                result.prepend ({ target, ids[i] });
             }
 
-            result.reverse ();
             return result;
         }
 
@@ -28,7 +28,7 @@ namespace Gala {
 		public string hotcorner_custom_command { get; set; }
 		public string[] dock_names { get; set; }
 
-		//public WindowOverviewType window_overview_type { get; set; }
+		public WindowOverviewType window_overview_type { get; set; }
 
 		public ActionType hotcorner_topleft { get; set; }
 		public ActionType hotcorner_topright { get; set; }
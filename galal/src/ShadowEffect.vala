@@ -22,15 +22,17 @@ namespace Gala {
         private class Shadow {
             public int users;
             public Cogl.Texture texture;
+            public int slice;
 
-            public Shadow (Cogl.Texture _texture) {
+            public Shadow (Cogl.Texture _texture, int _slice) {
                 texture = _texture;
+                slice = _slice;
                 users = 1;
             }
         }
 
-        // the sizes of the textures often repeat, especially for the background actor
-        // so we keep a cache to avoid creating the same texture all over again.
+        // the shadow only depends on its size, style and scale, so every texture is a small
+        // nine-slice template which is shared by all effects and stretched to the actual size.
         static Gee.HashMap<string,Shadow> shadow_cache;
         static Gtk.StyleContext style_context;
 
@@ -59,6 +61,7 @@ namespace Gala {
         Cogl.Material material;
 #endif
         string? current_key = null;
+        Shadow? current_shadow = null;
 
         public ShadowEffect (int shadow_size, int shadow_spread) {
             Object (shadow_size: shadow_size, shadow_spread: shadow_spread);
@@ -79,12 +82,12 @@ namespace Gala {
         }
 
 #if HAS_MUTTER336
-        Cogl.Texture? get_shadow (Cogl.Context context, int width, int height, int shadow_size, int shadow_spread) {
+        Cogl.Texture? get_shadow (Cogl.Context context, int shadow_size, int shadow_spread) {
 #else
-        Cogl.Texture? get_shadow (int width, int height, int shadow_size, int shadow_spread) {
+        Cogl.Texture? get_shadow (int shadow_size, int shadow_spread) {
 #endif
             var old_key = current_key;
-            current_key = "%ix%i:%i:%i".printf (width, height, shadow_size, shadow_spread);
+            current_key = "%i:%i:%s:%f".printf (shadow_size, shadow_spread, css_class ?? "", scale_factor);
             if (old_key == current_key)
                 return null;
 
@@ -94,13 +97,17 @@ namespace Gala {
             Shadow? shadow = null;
             if ((shadow = shadow_cache.@get (current_key)) != null) {
                 shadow.users++;
+                current_shadow = shadow;
                 return shadow.texture;
             }
 
-            var surface = new Cairo.ImageSurface (Cairo.Format.ARGB32, width, height);
+            // the corners have to cover the shadow outside of the window as well as
+            // its falloff and the rounded corners inside of it
+            var slice = (int) Math.ceilf (shadow_size * 2 * scale_factor);
+            var size = slice * 2 + 1;
+
+            var surface = new Cairo.ImageSurface (Cairo.Format.ARGB32, size, size);
             var cr = new Cairo.Context (surface);
-            cr.set_source_rgba (0, 0, 0, 0);
-            cr.fill ();
 
             cr.set_operator (Cairo.Operator.OVER);
             cr.save ();
@@ -110,21 +117,23 @@ namespace Gala {
                 style_context.add_class (css_class);
             }
 
+            var inner_size = size / scale_factor - shadow_size * 2;
             style_context.set_scale ((int)scale_factor);
-            style_context.render_background (cr, shadow_size, shadow_size, width - shadow_size * 2, height - shadow_size * 2);
+            style_context.render_background (cr, shadow_size, shadow_size, inner_size, inner_size);
             style_context.restore ();
             cr.restore ();
 
-            cr.paint ();
+            surface.flush ();
 
 #if HAS_MUTTER336
-            var texture = new Cogl.Texture2D.from_data (context, width, height, Cogl.PixelFormat.BGRA_8888_PRE,
+            var texture = new Cogl.Texture2D.from_data (context, size, size, Cogl.PixelFormat.BGRA_8888_PRE,
                 surface.get_stride (), surface.get_data ());
 #else
-            var texture = new Cogl.Texture.from_data (width, height, 0, Cogl.PixelFormat.BGRA_8888_PRE,
+            var texture = new Cogl.Texture.from_data (size, size, 0, Cogl.PixelFormat.BGRA_8888_PRE,
                 Cogl.PixelFormat.ANY, surface.get_stride (), surface.get_data ());
 #endif
-            shadow_cache.@set (current_key, new Shadow (texture));
+            current_shadow = new Shadow (texture, slice);
+            shadow_cache.@set (current_key, current_shadow);
 
             return texture;
         }
@@ -139,13 +148,57 @@ namespace Gala {
                 shadow_cache.unset (key);
         }
 
+        /**
+         * Paints the current shadow template stretched onto the given box. The corners
+         * are drawn unscaled, the edges and the center are stretched from the single
+         * row or column of texels in the middle of the template.
+         */
+#if HAS_MUTTER336
+        void paint_slices (Cogl.Framebuffer framebuffer, ActorBox box) {
+#else
+        void paint_slices (ActorBox box) {
+#endif
+            var tex_size = (float) (current_shadow.slice * 2 + 1);
+            var width = box.x2 - box.x1;
+            var height = box.y2 - box.y1;
+
+            // windows smaller than the template only use the outer part of the corners
+            var slice_x = float.min (current_shadow.slice, width / 2.0f);
+            var slice_y = float.min (current_shadow.slice, height / 2.0f);
+            var center = (current_shadow.slice + 0.5f) / tex_size;
+
+            float x[4] = { box.x1, box.x1 + slice_x, box.x2 - slice_x, box.x2 };
+            float y[4] = { box.y1, box.y1 + slice_y, box.y2 - slice_y, box.y2 };
+            float s1[3] = { 0.0f, center, 1.0f - slice_x / tex_size };
+            float s2[3] = { slice_x / tex_size, center, 1.0f };
+            float t1[3] = { 0.0f, center, 1.0f - slice_y / tex_size };
+            float t2[3] = { slice_y / tex_size, center, 1.0f };
+
+            for (var row = 0; row < 3; row++) {
+                if (y[row + 1] <= y[row])
+                    continue;
+
+                for (var col = 0; col < 3; col++) {
+                    if (x[col + 1] <= x[col])
+                        continue;
+
+#if HAS_MUTTER336
+                    framebuffer.draw_textured_rectangle (pipeline, x[col], y[row], x[col + 1], y[row + 1],
+                        s1[col], t1[row], s2[col], t2[row]);
+#else
+                    Cogl.rectangle_with_texture_coords (x[col], y[row], x[col + 1], y[row + 1],
+                        s1[col], t1[row], s2[col], t2[row]);
+#endif
+                }
+            }
+        }
+
 #if HAS_MUTTER336
         public override void paint (Clutter.PaintContext context, EffectPaintFlags flags) {
             var bounding_box = get_bounding_box ();
-            var width = (int) (bounding_box.x2 - bounding_box.x1);
-            var height = (int) (bounding_box.y2 - bounding_box.y1);
+            var framebuffer = context.get_framebuffer ();
 
-            var shadow = get_shadow (context.get_framebuffer ().get_context (), width, height, shadow_size, shadow_spread);
+            var shadow = get_shadow (framebuffer.get_context (), shadow_size, shadow_spread);
             if (shadow != null)
                 pipeline.set_layer_texture (0, shadow);
 
@@ -155,17 +208,15 @@ namespace Gala {
 
             pipeline.set_color (alpha);
 
-            context.get_framebuffer ().draw_rectangle (pipeline, bounding_box.x1, bounding_box.y1, bounding_box.x2, bounding_box.y2);
+            paint_slices (framebuffer, bounding_box);
 
             actor.continue_paint (context);
         }
 #else
         public override void paint (EffectPaintFlags flags) {
             var bounding_box = get_bounding_box ();
-            var width = (int) (bounding_box.x2 - bounding_box.x1);
-            var height = (int) (bounding_box.y2 - bounding_box.y1);
 
-            var shadow = get_shadow (width, height, shadow_size, shadow_spread);
+            var shadow = get_shadow (shadow_size, shadow_spread);
             if (shadow != null)
                 material.set_layer (0, shadow);
 
@@ -176,7 +227,7 @@ namespace Gala {
             material.set_color (alpha);
 
             Cogl.set_source (material);
-            Cogl.rectangle (bounding_box.x1, bounding_box.y1, bounding_box.x2, bounding_box.y2);
+            paint_slices (bounding_box);
 
             actor.continue_paint ();
         }
@@ -222,7 +222,8 @@ namespace Gala {
                 (int)height - padding_top - padding_bottom
             };
 
-            var window_positions = InternalUtils.calculate_grid_placement (area, windows);
+            var natural = BehaviorSettings.get_default ().window_overview_type == WindowOverviewType.NATURAL;
+            var window_positions = InternalUtils.calculate_grid_placement (area, windows, natural);
 
             foreach (var tilable in window_positions) {
                 unowned WindowClone window = (WindowClone) tilable.id;
@@ -0,0 +1,396 @@
+//
+//  Copyright (C) 2012 Tom Beckmann, Rico Tzschichholz
+//  Copyright (C) 2026 Gala Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+namespace Gala {
+    /**
+     * Places windows in a grid of equally sized slots, or naturally in rows
+     * keeping their relative sizes.
+     *
+     * The grid dimensions are picked to maximize the area covered by the
+     * scaled down windows. Windows are then assigned to the slots so that
+     * the total squared distance they have to travel is minimal.
+     *
+     * The natural layout doesn't letterbox the windows into slots, it picks
+     * the number of rows which allows the largest scale instead.
+     *
+     * Only depends on GLib so it can be benchmarked standalone.
+     */
+    public class WindowLayout {
+        public struct Rect {
+            public int x;
+            public int y;
+            public int width;
+            public int height;
+        }
+
+        // gap between a slot's border and its window
+        const int GAPS = 10;
+
+        // another grid has to cover this much more area to be preferred over the square one
+        const double GRID_SCORE_THRESHOLD = 1.01;
+
+        /**
+         * Calculates the targets of the given windows.
+         *
+         * @param area the area to place the windows in
+         * @param windows the current geometry of the windows
+         * @return the target geometry of each window, in the same order as the given windows
+         */
+        public static Rect[] calculate_grid (Rect area, Rect[] windows) {
+            var n = windows.length;
+            if (n == 0)
+                return {};
+
+            int columns, rows;
+            choose_grid (area, windows, out columns, out rows);
+
+            var slot_width = area.width / columns;
+            var slot_height = area.height / rows;
+
+            // see how many windows we have on the last row, it is centered if necessary
+            var left_over = n - columns * (rows - 1);
+
+            var slot_x = new int[n];
+            var slot_y = new int[n];
+            for (var slot = 0; slot < n; slot++) {
+                slot_x[slot] = area.x + (slot % columns) * slot_width;
+                slot_y[slot] = area.y + (slot / columns) * slot_height;
+
+                if (left_over != columns && slot >= columns * (rows - 1))
+                    slot_x[slot] += (columns - left_over) * slot_width / 2;
+            }
+
+            var cost = new int64[n * n];
+            for (var i = 0; i < n; i++) {
+                var center_x = windows[i].x + windows[i].width / 2;
+                var center_y = windows[i].y + windows[i].height / 2;
+
+                for (var slot = 0; slot < n; slot++) {
+                    int64 dx = slot_x[slot] + slot_width / 2 - center_x;
+                    int64 dy = slot_y[slot] + slot_height / 2 - center_y;
+                    cost[i * n + slot] = dx * dx + dy * dy;
+                }
+            }
+
+            var assignment = solve_assignment (cost, n);
+
+            var result = new Rect[n];
+            for (var i = 0; i < n; i++) {
+                var slot = assignment[i];
+                result[i] = fit_into_slot (windows[i], { slot_x[slot], slot_y[slot], slot_width, slot_height });
+            }
+
+            return result;
+        }
+
+        /**
+         * Calculates the targets of the given windows, keeping their aspect ratios
+         * and relative sizes instead of fitting them into equally sized slots.
+         *
+         * Windows are put into rows by their vertical position and are ordered by
+         * their horizontal position within a row.
+         *
+         * @param area the area to place the windows in
+         * @param windows the current geometry of the windows
+         * @return the target geometry of each window, in the same order as the given windows
+         */
+        public static Rect[] calculate_natural (Rect area, Rect[] windows) {
+            var n = windows.length;
+            if (n == 0)
+                return {};
+
+            // fill the rows from top to bottom
+            var order = new int[n];
+            for (var i = 0; i < n; i++)
+                order[i] = i;
+            sort_by_center (windows, order, 0, n, false);
+
+            var best_rows = 1;
+            var best_score = 0.0;
+            for (var rows = 1; rows <= n; rows++) {
+                var score = layout_rows (area, windows, order, rows, null);
+                if (score > best_score) {
+                    best_score = score;
+                    best_rows = rows;
+                }
+            }
+
+            var result = new Rect[n];
+            layout_rows (area, windows, order, best_rows, result);
+
+            return result;
+        }
+
+        /**
+         * Splits the ordered windows into rows of about the same width and
+         * scales all of them by the same factor to fit into the area.
+         *
+         * @param targets receives the target geometry of each window, if given
+         * @return the area covered by the scaled windows
+         */
+        static double layout_rows (Rect area, Rect[] windows, int[] order, int rows, Rect[]? targets) {
+            var n = order.length;
+
+            var total_width = 0.0;
+            var window_area = 0.0;
+            foreach (var window in windows) {
+                total_width += natural_width (window);
+                window_area += (double) int.max (window.width, 1) * int.max (window.height, 1);
+            }
+            var row_width = total_width / rows;
+
+            // the windows of a row are consecutive in the order, starting at row_start
+            var row_start = new int[rows + 1];
+            var row_widths = new double[rows];
+            var row_heights = new double[rows];
+            var row = 0;
+            var filled = 0.0;
+            for (var k = 0; k < n; k++) {
+                var width = natural_width (windows[order[k]]);
+
+                // a window belongs to the row its center falls into
+                while (row < rows - 1 && filled + width / 2 > row_width * (row + 1)) {
+                    row++;
+                    row_start[row] = k;
+                }
+
+                row_widths[row] += width;
+                row_heights[row] = double.max (row_heights[row], natural_height (windows[order[k]]));
+                filled += width;
+            }
+            for (var r = row + 1; r <= rows; r++)
+                row_start[r] = n;
+
+            var max_width = 0.0;
+            var total_height = 0.0;
+            for (var r = 0; r < rows; r++) {
+                max_width = double.max (max_width, row_widths[r]);
+                total_height += row_heights[r];
+            }
+
+            // Don't scale the windows up
+            var scale = double.min (1.0, double.min (area.width / max_width, area.height / total_height));
+            if (scale <= 0)
+                return 0.0;
+
+            if (targets == null)
+                return scale * scale * window_area;
+
+            var y = area.y + (area.height - total_height * scale) / 2;
+            for (var r = 0; r < rows; r++) {
+                sort_by_center (windows, order, row_start[r], row_start[r + 1], true);
+
+                var x = area.x + (area.width - row_widths[r] * scale) / 2;
+                for (var k = row_start[r]; k < row_start[r + 1]; k++) {
+                    var i = order[k];
+                    var width = natural_width (windows[i]);
+                    var height = natural_height (windows[i]);
+
+                    targets[i] = {
+                        (int) (x + GAPS * scale),
+                        (int) (y + ((row_heights[r] - height) / 2 + GAPS) * scale),
+                        (int) ((width - 2 * GAPS) * scale),
+                        (int) ((height - 2 * GAPS) * scale)
+                    };
+
+                    x += width * scale;
+                }
+
+                y += row_heights[r] * scale;
+            }
+
+            return scale * scale * window_area;
+        }
+
+        static double natural_width (Rect window) {
+            return int.max (window.width, 1) + 2 * GAPS;
+        }
+
+        static double natural_height (Rect window) {
+            return int.max (window.height, 1) + 2 * GAPS;
+        }
+
+        /**
+         * Sorts order[start:end] by the centers of the windows, keeping the
+         * order of windows with the same center.
+         */
+        static void sort_by_center (Rect[] windows, int[] order, int start, int end, bool horizontal) {
+            for (var k = start + 1; k < end; k++) {
+                var i = order[k];
+                var center = get_center (windows[i], horizontal);
+
+                var j = k - 1;
+                for (; j >= start && get_center (windows[order[j]], horizontal) > center; j--)
+                    order[j + 1] = order[j];
+
+                order[j + 1] = i;
+            }
+        }
+
+        static int get_center (Rect window, bool horizontal) {
+            return horizontal ? window.x + window.width / 2 : window.y + window.height / 2;
+        }
+
+        /**
+         * Picks the number of columns which results in the largest total area of
+         * the scaled windows, starting with a square grid.
+         */
+        static void choose_grid (Rect area, Rect[] windows, out int columns, out int rows) {
+            var n = windows.length;
+
+            columns = (int) Math.ceil (Math.sqrt (n));
+            rows = (int) Math.ceil (n / (double) columns);
+
+            var best_score = grid_score (area, windows, columns, rows);
+
+            for (var c = 1; c <= n; c++) {
+                if (c == columns)
+                    continue;
+
+                var r = (int) Math.ceil (n / (double) c);
+                var score = grid_score (area, windows, c, r);
+                if (score > best_score * GRID_SCORE_THRESHOLD) {
+                    best_score = score;
+                    columns = c;
+                    rows = r;
+                }
+            }
+        }
+
+        static double grid_score (Rect area, Rect[] windows, int columns, int rows) {
+            var slot_width = area.width / (double) columns - 2 * GAPS;
+            var slot_height = area.height / (double) rows - 2 * GAPS;
+
+            if (slot_width <= 0 || slot_height <= 0)
+                return 0.0;
+
+            var score = 0.0;
+            foreach (var window in windows) {
+                if (window.width <= 0 || window.height <= 0)
+                    continue;
+
+                var scale = double.min (1.0, double.min (slot_width / window.width, slot_height / window.height));
+                score += scale * scale * window.width * window.height;
+            }
+
+            return score;
+        }
+
+        /**
+         * Solves the square assignment problem given by the flattened n*n cost
+         * matrix with the Hungarian method in O(n^3).
+         *
+         * @return the slot for each window
+         */
+        static int[] solve_assignment (int64[] cost, int n) {
+            // 1-based, index 0 is a virtual window/slot
+            var u = new int64[n + 1];
+            var v = new int64[n + 1];
+            var owner = new int[n + 1];
+            var way = new int[n + 1];
+            var min_slack = new int64[n + 1];
+            var used = new bool[n + 1];
+
+            for (var i = 1; i <= n; i++) {
+                owner[0] = i;
+                var j0 = 0;
+
+                for (var j = 0; j <= n; j++) {
+                    min_slack[j] = int64.MAX;
+                    used[j] = false;
+                }
+
+                do {
+                    used[j0] = true;
+                    var i0 = owner[j0];
+                    var delta = int64.MAX;
+                    var j1 = 0;
+
+                    for (var j = 1; j <= n; j++) {
+                        if (used[j])
+                            continue;
+
+                        var slack = cost[(i0 - 1) * n + j - 1] - u[i0] - v[j];
+                        if (slack < min_slack[j]) {
+                            min_slack[j] = slack;
+                            way[j] = j0;
+                        }
+
+                        if (min_slack[j] < delta) {
+                            delta = min_slack[j];
+                            j1 = j;
+                        }
+                    }
+
+                    for (var j = 0; j <= n; j++) {
+                        if (used[j]) {
+                            u[owner[j]] += delta;
+                            v[j] -= delta;
+                        } else {
+                            min_slack[j] -= delta;
+                        }
+                    }
+
+                    j0 = j1;
+                } while (owner[j0] != 0);
+
+                // augment along the found path
+                do {
+                    var j1 = way[j0];
+                    owner[j0] = owner[j1];
+                    j0 = j1;
+                } while (j0 != 0);
+            }
+
+            var assignment = new int[n];
+            for (var j = 1; j <= n; j++)
+                assignment[owner[j] - 1] = j - 1;
+
+            return assignment;
+        }
+
+        static Rect fit_into_slot (Rect window, Rect slot) {
+            Rect target = { slot.x + GAPS, slot.y + GAPS, slot.width - 2 * GAPS, slot.height - 2 * GAPS };
+
+            if (window.width <= 0 || window.height <= 0)
+                return target;
+
+            float scale;
+            if (target.width / (double) window.width < target.height / (double) window.height) {
+                // Center vertically
+                scale = target.width / (float) window.width;
+                target.y += (target.height - (int) (window.height * scale)) / 2;
+                target.height = (int) Math.floorf (window.height * scale);
+            } else {
+                // Center horizontally
+                scale = target.height / (float) window.height;
+                target.x += (target.width - (int) (window.width * scale)) / 2;
+                target.width = (int) Math.floorf (window.width * scale);
+            }
+
+            // Don't scale the windows too much
+            if (scale > 1.0) {
+                var center_x = target.x + target.width / 2;
+                var center_y = target.y + target.height / 2;
+                target = { center_x - window.width / 2, center_y - window.height / 2, window.width, window.height };
+            }
+
+            return target;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+//
+//  Copyright (C) 2026 Gala Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+/*
+ * Lays out synthetic sets of windows on a 1920x1080 area with the grid and
+ * the natural layout and reports the average time per layout, the share of
+ * the area covered by the windows and the average distance a window travels
+ * to its slot.
+ */
+namespace Gala {
+    const int AREA_WIDTH = 1920;
+    const int AREA_HEIGHT = 1080;
+    const int MIN_ITERATIONS = 3;
+    const int64 MIN_DURATION = 500000;
+
+    static WindowLayout.Rect[] create_windows (Rand rand, int count) {
+        var windows = new WindowLayout.Rect[count];
+
+        for (var i = 0; i < count; i++) {
+            var width = rand.int_range (200, AREA_WIDTH);
+            var height = rand.int_range (150, AREA_HEIGHT);
+            windows[i] = {
+                rand.int_range (0, AREA_WIDTH - width + 1),
+                rand.int_range (0, AREA_HEIGHT - height + 1),
+                width,
+                height
+            };
+        }
+
+        return windows;
+    }
+
+    static bool run (WindowLayout.Rect area, WindowLayout.Rect[] windows, bool natural) {
+        var count = windows.length;
+        WindowLayout.Rect[] targets = {};
+
+        var iterations = 0;
+        var start = get_monotonic_time ();
+        do {
+            targets = natural
+                ? WindowLayout.calculate_natural (area, windows)
+                : WindowLayout.calculate_grid (area, windows);
+            iterations++;
+        } while (iterations < MIN_ITERATIONS || get_monotonic_time () - start < MIN_DURATION);
+        var elapsed = get_monotonic_time () - start;
+
+        if (targets.length != count) {
+            printerr ("Expected %i targets, got %i\n", count, targets.length);
+            return false;
+        }
+
+        var covered = 0.0;
+        var distance = 0.0;
+        for (var i = 0; i < count; i++) {
+            covered += (double) targets[i].width * targets[i].height;
+
+            var dx = (targets[i].x + targets[i].width / 2) - (windows[i].x + windows[i].width / 2);
+            var dy = (targets[i].y + targets[i].height / 2) - (windows[i].y + windows[i].height / 2);
+            distance += Math.sqrt ((double) dx * dx + (double) dy * dy);
+        }
+
+        print ("%8s %8i %12.3f %9.1f%% %12.1f\n", natural ? "natural" : "grid", count,
+            elapsed / 1000.0 / iterations, 100.0 * covered / ((double) AREA_WIDTH * AREA_HEIGHT), distance / count);
+
+        return true;
+    }
+
+    public static int main (string[] args) {
+        int[] counts = { 10, 25, 50, 100, 200, 350, 500 };
+        WindowLayout.Rect area = { 0, 0, AREA_WIDTH, AREA_HEIGHT };
+        var rand = new Rand.with_seed (42);
+
+        print ("%8s %8s %12s %10s %12s\n", "layout", "windows", "time (ms)", "coverage", "distance");
+
+        foreach (var count in counts) {
+            var windows = create_windows (rand, count);
+
+            if (!run (area, windows, false) || !run (area, windows, true))
+                return 1;
+        }
+
+        return 0;
+    }
+}
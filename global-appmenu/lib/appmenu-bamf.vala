@@ -21,7 +21,7 @@ using Gtk;
 
 namespace Appmenu
 {
-    DBusMenuHelper get_dbus_menu_helper_with_bamf(MenuWidget w, string name, ObjectPath path, Bamf.Application? app)
+    DBusMenuHelper get_dbus_menu_helper_with_bamf(MenuWidget w, DBusMenu.Importer importer, string name, Bamf.Application? app)
     {
         string? title = null;
         DesktopAppInfo? info = null;
@@ -36,7 +36,7 @@ namespace Appmenu
         }
         if (title == null && app != null)
             title = app.get_name();
-        return new DBusMenuHelper(w,name,path,title,info);
+        return new DBusMenuHelper(w,importer,name,title,info);
     }
     MenuModelHelper get_menu_model_helper_with_bamf(MenuWidget w, Bamf.Window window, Bamf.Application? app)
     {
@@ -80,6 +80,7 @@ namespace Appmenu
     internal class BackendBAMF : Backend
     {
         private HashTable<uint,unowned Bamf.Window> desktop_menus;
+        private DBusMenuCache dbusmenu_cache;
         private Bamf.Matcher matcher;
         private Helper helper;
         private Bamf.Application active_application;
@@ -87,6 +88,7 @@ namespace Appmenu
         construct
         {
             desktop_menus = new HashTable<uint,unowned Bamf.Window>(direct_hash,direct_equal);
+            dbusmenu_cache = new DBusMenuCache();
             matcher = Bamf.Matcher.get_default();
             proxy.window_registered.connect(register_menu_window);
             proxy.window_unregistered.connect(unregister_menu_window);
@@ -129,7 +131,10 @@ namespace Appmenu
         private void register_menu_window(uint window_id, string sender, ObjectPath menu_object_path)
         {
             if (window_id != matcher.get_active_window().get_xid())
+            {
+                dbusmenu_cache.prefetch(window_id,sender,menu_object_path);
                 return;
+            }
             this.active_window = matcher.get_active_window();
             this.type = ModelType.DBUSMENU;
             active_model_changed();
@@ -141,11 +146,13 @@ namespace Appmenu
             ObjectPath path;
             proxy.get_menu_for_window(xid,out name, out path);
             active_application = matcher.get_application_for_xid(xid);
-            helper = get_dbus_menu_helper_with_bamf(menu,name,path,active_application);
+            var importer = dbusmenu_cache.lookup(xid,name,path);
+            helper = get_dbus_menu_helper_with_bamf(menu,importer,name,active_application);
         }
         private void unregister_menu_window(uint window_id)
         {
             desktop_menus.remove(window_id);
+            dbusmenu_cache.remove(window_id);
         }
         private void on_window_opened(Bamf.View view)
         {
@@ -128,7 +128,12 @@ static void dbus_menu_importer_dispose(GObject *object)
 	}
 	g_cancellable_cancel(menu->cancellable);
 	g_clear_object(&menu->cancellable);
-	g_signal_handlers_disconnect_by_data(menu->top_model, menu);
+	if (menu->top_model != NULL)
+	{
+		g_signal_handlers_disconnect_by_data(menu->top_model, menu);
+		// Cancels pending calls of all submenus, as model can outlive importer
+		g_object_set(menu->top_model, "xml", NULL, NULL);
+	}
 	g_clear_object(&menu->top_model);
 	g_clear_object(&menu->proxy);
 	g_clear_object(&menu->all_actions);
@@ -253,3 +258,24 @@ DBusMenuImporter *dbus_menu_importer_new(const char *bus_name, const char *objec
 	                    object_path,
 	                    NULL);
 }
+
+void dbus_menu_importer_get_stats(DBusMenuImporter *menu, guint *requests, guint *slow_requests,
+                                  guint *timed_out_requests, gint64 *max_latency)
+{
+	g_return_if_fail(DBUS_MENU_IS_IMPORTER(menu));
+	const DBusMenuStats *stats = dbus_menu_model_get_stats(menu->top_model);
+	if (requests != NULL)
+		*requests = stats != NULL ? stats->requests : 0;
+	if (slow_requests != NULL)
+		*slow_requests = stats != NULL ? stats->slow_requests : 0;
+	if (timed_out_requests != NULL)
+		*timed_out_requests = stats != NULL ? stats->timed_out_requests : 0;
+	if (max_latency != NULL)
+		*max_latency = stats != NULL ? stats->max_latency : 0;
+}
+
+guint dbus_menu_importer_get_n_items(DBusMenuImporter *menu)
+{
+	g_return_val_if_fail(DBUS_MENU_IS_IMPORTER(menu), 0);
+	return dbus_menu_model_count_items(menu->top_model);
+}
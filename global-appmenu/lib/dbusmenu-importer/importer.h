@@ -27,6 +27,11 @@ G_BEGIN_DECLS
 G_DECLARE_FINAL_TYPE(DBusMenuImporter, dbus_menu_importer, DBUS_MENU, IMPORTER, GObject)
 
 DBusMenuImporter *dbus_menu_importer_new(const char *bus_name, const char *object_path);
+// Counts remote calls of the menu, slow ones and timed out ones, latency is in microseconds
+void dbus_menu_importer_get_stats(DBusMenuImporter *menu, guint *requests, guint *slow_requests,
+                                  guint *timed_out_requests, gint64 *max_latency);
+// Counts items loaded in all menus of the importer
+guint dbus_menu_importer_get_n_items(DBusMenuImporter *menu);
 
 G_END_DECLS
 
@@ -30,14 +30,24 @@ struct _DBusMenuModel
 
 	uint parent_id;
 	uint current_revision;
+	uint queued_revision;
 	GCancellable *cancellable;
 	DBusMenuXml *xml;
 	GActionGroup *received_action_group;
 	GSequence *sections;
+	GHashTable *item_index;
 	bool layout_update_required;
 	bool layout_update_in_progress;
+	bool layout_request_pending;
+	bool layout_update_queued;
 };
 
+// Remote menus get this long (in ms) to answer, so a hung app cannot hold the panel
+#define REQUEST_TIMEOUT 3000
+// Answers taking longer (in us) are counted as slow
+#define SLOW_REQUEST_TIME (G_USEC_PER_SEC / 2)
+#define STATS_KEY "dbus-menu-stats"
+
 static const char *property_names[] = { "accessible-desc",
 	                                "children-display",
 	                                "disposition",
@@ -64,6 +74,7 @@ static GParamSpec *properties[NUM_PROPS] = { NULL };
 
 static DBusMenuItem *dbus_menu_model_find(DBusMenuModel *menu, uint item_id, int *section_num,
                                           int *position);
+static void dbus_menu_model_rebuild_index(DBusMenuModel *menu);
 
 G_DEFINE_TYPE(DBusMenuModel, dbus_menu_model, G_TYPE_MENU_MODEL)
 
@@ -367,6 +378,8 @@ static void layout_parse(DBusMenuModel *menu, GVariant *layout)
 	int secdiff = old_sections - section_num;
 	g_sequence_remove_range(g_sequence_get_iter_at_pos(menu->sections, section_num),
 	                        g_sequence_get_end_iter(menu->sections));
+	// Layout is final now, so index it before anyone is notified
+	dbus_menu_model_rebuild_index(menu);
 	// If section number is not changed, emit a signal about last section.
 	// Because if we emit it and section will be a part of sections signal, this can
 	// duplicate menu items
@@ -392,122 +405,251 @@ static void layout_parse(DBusMenuModel *menu, GVariant *layout)
 	queue_emit_all(signal_queue);
 }
 
-static void get_layout_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
+// Stats are kept per proxy, so they cover all submenus of a remote app
+static DBusMenuStats *dbus_menu_xml_get_stats(DBusMenuXml *xml)
+{
+	DBusMenuStats *stats = (DBusMenuStats *)g_object_get_data(G_OBJECT(xml), STATS_KEY);
+	if (stats == NULL)
+	{
+		stats = g_new0(DBusMenuStats, 1);
+		g_object_set_data_full(G_OBJECT(xml), STATS_KEY, stats, g_free);
+	}
+	return stats;
+}
+
+G_GNUC_INTERNAL const DBusMenuStats *dbus_menu_model_get_stats(DBusMenuModel *menu)
+{
+	g_return_val_if_fail(DBUS_MENU_IS_MODEL(menu), NULL);
+	if (!DBUS_MENU_IS_XML(menu->xml))
+		return NULL;
+	return dbus_menu_xml_get_stats(menu->xml);
+}
+
+// Does not keep the model alive, answers for a finalized model are dropped
+struct remote_request
+{
+	GWeakRef menu;
+	uint id;
+	gint64 started;
+};
+
+static struct remote_request *remote_request_new(DBusMenuModel *menu, uint id)
+{
+	struct remote_request *request = g_new0(struct remote_request, 1);
+	g_weak_ref_init(&request->menu, menu);
+	request->id      = id;
+	request->started = g_get_monotonic_time();
+	return request;
+}
+
+static void remote_request_free(struct remote_request *request)
+{
+	g_weak_ref_clear(&request->menu);
+	g_free(request);
+}
+
+// Finishes the call, accounts it in stats and frees the request. Returns the model, or NULL
+// if it is gone meanwhile. Reply is NULL on errors and for answers from a proxy which is not
+// used by the model anymore.
+static DBusMenuModel *remote_request_finish(struct remote_request *request, GObject *source_object,
+                                            GAsyncResult *res, const char *method, uint *id,
+                                            GVariant **reply)
 {
-	g_autoptr(GVariant) layout = NULL;
-	guint revision;
-	if (!DBUS_MENU_IS_MODEL(user_data))
-		return;
-	DBusMenuModel *menu     = DBUS_MENU_MODEL(user_data);
 	g_autoptr(GError) error = NULL;
-	dbus_menu_xml_call_get_layout_finish((DBusMenuXml *)(source_object),
-	                                     &revision,
-	                                     &layout,
-	                                     res,
-	                                     &error);
+	g_autoptr(GVariant) ret = g_dbus_proxy_call_finish(G_DBUS_PROXY(source_object), res, &error);
+	DBusMenuModel *menu     = (DBusMenuModel *)g_weak_ref_get(&request->menu);
+	gint64 latency          = g_get_monotonic_time() - request->started;
+	*id                     = request->id;
+	*reply                  = NULL;
+	remote_request_free(request);
+	if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		return menu;
+	DBusMenuStats *stats = dbus_menu_xml_get_stats(DBUS_MENU_XML(source_object));
+	stats->requests++;
+	stats->max_latency = MAX(stats->max_latency, latency);
+	if (latency > SLOW_REQUEST_TIME)
+	{
+		stats->slow_requests++;
+		g_debug("%s: %s for %u took %" G_GINT64_FORMAT " ms",
+		        g_dbus_proxy_get_name(G_DBUS_PROXY(source_object)),
+		        method,
+		        *id,
+		        latency / 1000);
+	}
 	if (error != NULL)
 	{
-		if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
-			g_warning("%s", error->message);
+		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT))
+			stats->timed_out_requests++;
+		g_warning("%s", error->message);
+		return menu;
+	}
+	if (menu != NULL && (GObject *)menu->xml == source_object)
+		*reply = g_steal_pointer(&ret);
+	return menu;
+}
+
+static void layout_request(DBusMenuModel *menu, uint revision);
+
+static void get_layout_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(GVariant) reply = NULL;
+	uint id;
+	g_autoptr(DBusMenuModel) menu =
+	    remote_request_finish(user_data, source_object, res, "GetLayout", &id, &reply);
+	if (menu == NULL)
 		return;
+	menu->layout_request_pending = false;
+	if (reply != NULL)
+	{
+		guint revision;
+		g_autoptr(GVariant) layout = NULL;
+		g_variant_get(reply, "(u@(ia{sv}av))", &revision, &layout);
+		layout_parse(menu, layout);
+		menu->layout_update_in_progress = false;
+		menu->current_revision          = MAX(menu->current_revision, revision);
 	}
-	layout_parse(menu, layout);
-	menu->layout_update_in_progress = false;
-	if (menu->layout_update_required)
-		dbus_menu_model_update_layout(menu);
+	else
+	{
+		// Try again when menu is opened next time
+		menu->layout_update_required = true;
+	}
+	// Requests made while waiting are satisfied by this answer if it has their revision.
+	// Answer of replaced proxy satisfies nothing.
+	bool stale = (GObject *)menu->xml != source_object;
+	bool again = menu->layout_update_queued &&
+	             (stale || (reply != NULL && menu->current_revision < menu->queued_revision));
+	menu->layout_update_queued = false;
+	menu->queued_revision      = 0;
+	if (again)
+		layout_request(menu, 0);
 }
 
-static void dbus_menu_update_item_properties_from_layout_sync(DBusMenuModel *menu,
-                                                              DBusMenuItem *item, int sect_n,
-                                                              int pos)
+// Requests layout, if a request is already running, it is queued until its answer.
+// Queued request is dropped if answer already has at least given revision.
+static void layout_request(DBusMenuModel *menu, uint revision)
 {
-	g_return_if_fail(DBUS_MENU_IS_MODEL(menu));
-	g_autoptr(GVariant) props      = NULL;
-	g_autoptr(GVariant) items      = NULL;
-	g_autoptr(GVariant) layout     = NULL;
-	g_autoptr(GError) error        = NULL;
-	g_autoptr(GQueue) signal_queue = g_queue_new();
-	guint id, revision;
-	dbus_menu_xml_call_get_layout_sync(menu->xml,
-	                                   item->id,
-	                                   0,
-	                                   property_names,
-	                                   &revision,
-	                                   &layout,
-	                                   menu->cancellable,
-	                                   &error);
-	if (error != NULL)
+	if (menu->layout_request_pending)
 	{
-		if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
-			g_warning("%s", error->message);
+		menu->layout_update_queued = true;
+		menu->queued_revision      = MAX(menu->queued_revision, revision);
 		return;
 	}
-	g_variant_get(layout, "(i@a{sv}@av)", &id, &props, &items);
-	bool is_item_updated = dbus_menu_item_update_props(item, props);
-	if (is_item_updated)
-		add_signal_to_queue(menu, signal_queue, sect_n, pos, 1, 1);
-	queue_emit_all(signal_queue);
+	if (!DBUS_MENU_IS_XML(menu->xml))
+	{
+		menu->layout_update_required = true;
+		return;
+	}
+	menu->layout_request_pending = true;
+	g_dbus_proxy_call(G_DBUS_PROXY(menu->xml),
+	                  "GetLayout",
+	                  g_variant_new("(ii^as)", (int)menu->parent_id, 1, property_names),
+	                  G_DBUS_CALL_FLAGS_NONE,
+	                  REQUEST_TIMEOUT,
+	                  menu->cancellable,
+	                  get_layout_cb,
+	                  remote_request_new(menu, menu->parent_id));
 }
 
-G_GNUC_INTERNAL void dbus_menu_model_update_layout_sync(DBusMenuModel *menu)
+static void get_item_layout_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
 {
-	g_return_if_fail(DBUS_MENU_IS_MODEL(menu));
-	g_autoptr(GVariant) layout = NULL;
-	g_autoptr(GError) error    = NULL;
-	guint revision;
-	if (menu->layout_update_in_progress)
-		menu->layout_update_required = true;
-	else
-		dbus_menu_xml_call_get_layout_sync(menu->xml,
-		                                   menu->parent_id,
-		                                   1,
-		                                   property_names,
-		                                   &revision,
-		                                   &layout,
-		                                   menu->cancellable,
-		                                   &error);
-	if (error != NULL)
+	g_autoptr(GVariant) reply = NULL;
+	uint item_id;
+	g_autoptr(DBusMenuModel) menu =
+	    remote_request_finish(user_data, source_object, res, "GetLayout", &item_id, &reply);
+	// Item can be gone with layout update meanwhile, so look it up by id again
+	int sect_n = 0, position = 0;
+	DBusMenuItem *item = NULL;
+	if (reply != NULL && !menu->layout_update_in_progress)
+		item = dbus_menu_model_find(menu, item_id, &sect_n, &position);
+	if (item != NULL)
 	{
-		if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
-			g_warning("%s", error->message);
-		return;
+		guint id, revision;
+		g_autoptr(GVariant) props      = NULL;
+		g_autoptr(GVariant) items      = NULL;
+		g_autoptr(GQueue) signal_queue = g_queue_new();
+		g_variant_get(reply, "(u(i@a{sv}@av))", &revision, &id, &props, &items);
+		bool is_item_updated = dbus_menu_item_update_props(item, props);
+		if (is_item_updated)
+			add_signal_to_queue(menu, signal_queue, sect_n, position, 1, 1);
+		queue_emit_all(signal_queue);
 	}
-	layout_parse(menu, layout);
-	menu->layout_update_in_progress = false;
-	if (menu->layout_update_required)
-		dbus_menu_model_update_layout_sync(menu);
+}
+
+static void dbus_menu_update_item_properties_from_layout(DBusMenuModel *menu, uint id)
+{
+	g_dbus_proxy_call(G_DBUS_PROXY(menu->xml),
+	                  "GetLayout",
+	                  g_variant_new("(ii^as)", (int)id, 0, property_names),
+	                  G_DBUS_CALL_FLAGS_NONE,
+	                  REQUEST_TIMEOUT,
+	                  menu->cancellable,
+	                  get_item_layout_cb,
+	                  remote_request_new(menu, id));
 }
 
 G_GNUC_INTERNAL void dbus_menu_model_update_layout(DBusMenuModel *menu)
 {
 	g_return_if_fail(DBUS_MENU_IS_MODEL(menu));
-	if (menu->layout_update_in_progress)
-		menu->layout_update_required = true;
-	else
-		dbus_menu_xml_call_get_layout(menu->xml,
-		                              menu->parent_id,
-		                              1,
-		                              property_names,
-		                              menu->cancellable,
-		                              get_layout_cb,
-		                              menu);
+	// Reason is unknown, so no answer which was requested before can satisfy it
+	layout_request(menu, UINT_MAX);
+}
+
+static void about_to_show_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(GVariant) reply = NULL;
+	uint id;
+	g_autoptr(DBusMenuModel) menu =
+	    remote_request_finish(user_data, source_object, res, "AboutToShow", &id, &reply);
+	if (menu == NULL)
+		return;
+	gboolean need_update = false;
+	if (reply != NULL)
+		g_variant_get(reply, "(b)", &need_update);
+	if (need_update || menu->layout_update_required)
+		dbus_menu_model_update_layout(menu);
+}
+
+G_GNUC_INTERNAL void dbus_menu_model_about_to_show(DBusMenuModel *menu)
+{
+	g_return_if_fail(DBUS_MENU_IS_MODEL(menu));
+	if (!DBUS_MENU_IS_XML(menu->xml))
+		return;
+	// Use opened before actual open. For Firefox.
+	dbus_menu_xml_call_event(menu->xml,
+	                         menu->parent_id,
+	                         "opened",
+	                         g_variant_new("v", g_variant_new_int32(0)),
+	                         CURRENT_TIME,
+	                         NULL,
+	                         NULL,
+	                         NULL);
+	g_dbus_proxy_call(G_DBUS_PROXY(menu->xml),
+	                  "AboutToShow",
+	                  g_variant_new("(i)", (int)menu->parent_id),
+	                  G_DBUS_CALL_FLAGS_NONE,
+	                  REQUEST_TIMEOUT,
+	                  menu->cancellable,
+	                  about_to_show_cb,
+	                  remote_request_new(menu, menu->parent_id));
 }
 
 static void layout_updated_cb(DBusMenuXml *proxy, guint revision, gint parent, DBusMenuModel *menu)
 {
 	if (!DBUS_MENU_IS_XML(proxy))
 		return;
-	if (((uint)parent == menu->parent_id) && menu->current_revision < revision)
+	if ((uint)parent == menu->parent_id)
 	{
-		g_debug("Remote attempt to update %u with rev %u\n", parent, revision);
-		dbus_menu_model_update_layout(menu);
-		menu->current_revision = revision;
+		if (menu->current_revision < revision)
+		{
+			g_debug("Remote attempt to update %u with rev %u\n", parent, revision);
+			layout_request(menu, revision);
+		}
 		return;
 	}
 	int sect_n = 0, position = 0;
 	DBusMenuItem *item = dbus_menu_model_find(menu, (uint)parent, &sect_n, &position);
 	if (item != NULL)
-		dbus_menu_update_item_properties_from_layout_sync(menu, item, sect_n, position);
+		dbus_menu_update_item_properties_from_layout(menu, item->id);
 }
 
 static void item_activation_requested_cb(DBusMenuXml *proxy, gint id, guint timestamp,
@@ -520,7 +662,29 @@ static void item_activation_requested_cb(DBusMenuXml *proxy, gint id, guint time
 	g_debug("activation requested: id - %d, timestamp - %d", id, timestamp);
 }
 
-static void items_properties_loop(DBusMenuModel *menu, GVariant *up_props, GQueue *signal_queue,
+struct changed_range
+{
+	int first;
+	int last;
+};
+
+static void changed_range_add(GHashTable *changed, int sect_n, int position)
+{
+	struct changed_range *range =
+	    (struct changed_range *)g_hash_table_lookup(changed, GINT_TO_POINTER(sect_n));
+	if (range == NULL)
+	{
+		range        = g_new0(struct changed_range, 1);
+		range->first = position;
+		range->last  = position;
+		g_hash_table_insert(changed, GINT_TO_POINTER(sect_n), range);
+		return;
+	}
+	range->first = MIN(range->first, position);
+	range->last  = MAX(range->last, position);
+}
+
+static void items_properties_loop(DBusMenuModel *menu, GVariant *up_props, GHashTable *changed,
                                   bool is_removal)
 {
 	GVariantIter iter;
@@ -546,12 +710,7 @@ static void items_properties_loop(DBusMenuModel *menu, GVariant *up_props, GQueu
 				                      ? dbus_menu_item_update_props(item, props)
 				                      : dbus_menu_item_remove_props(item, props);
 				if (is_item_updated)
-					add_signal_to_queue(menu,
-					                    signal_queue,
-					                    sect_n,
-					                    position,
-					                    1,
-					                    1);
+					changed_range_add(changed, sect_n, position);
 			}
 		}
 	}
@@ -565,8 +724,26 @@ static void items_properties_updated_cb(DBusMenuXml *proxy, GVariant *updated_pr
 	if (menu->layout_update_in_progress == true)
 		return;
 	g_autoptr(GQueue) signal_queue = g_queue_new();
-	items_properties_loop(menu, updated_props, signal_queue, false);
-	items_properties_loop(menu, removed_props, signal_queue, true);
+	// Apps send hundreds of updates at once, so emit only one signal per section,
+	// spanning all updated items of it
+	g_autoptr(GHashTable) changed =
+	    g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+	items_properties_loop(menu, updated_props, changed, false);
+	items_properties_loop(menu, removed_props, changed, true);
+	GHashTableIter iter;
+	gpointer key, value;
+	g_hash_table_iter_init(&iter, changed);
+	while (g_hash_table_iter_next(&iter, &key, &value))
+	{
+		struct changed_range *range = (struct changed_range *)value;
+		int n_items                 = range->last - range->first + 1;
+		add_signal_to_queue(menu,
+		                    signal_queue,
+		                    GPOINTER_TO_INT(key),
+		                    range->first,
+		                    n_items,
+		                    n_items);
+	}
 	queue_emit_all(signal_queue);
 }
 
@@ -613,11 +790,16 @@ static void dbus_menu_model_set_property(GObject *object, guint property_id, con
 	{
 	case PROP_XML:
 		menu->xml = DBUS_MENU_XML(g_value_get_object(value));
-		if (menu->xml != NULL && old_xml != menu->xml)
+		if (old_xml != menu->xml)
 		{
 			if (old_xml != NULL)
 				g_signal_handlers_disconnect_by_data(old_xml, menu);
-			on_xml_property_changed(menu);
+			// Answers for previous proxy are useless now
+			g_cancellable_cancel(menu->cancellable);
+			g_object_unref(menu->cancellable);
+			menu->cancellable = g_cancellable_new();
+			if (menu->xml != NULL)
+				on_xml_property_changed(menu);
 		}
 		break;
 	case PROP_ACTION_GROUP:
@@ -667,40 +849,88 @@ G_GNUC_INTERNAL void dbus_menu_model_set_layout_update_required(DBusMenuModel *m
 	model->layout_update_required = required;
 }
 
-static DBusMenuItem *dbus_menu_model_find(DBusMenuModel *menu, uint item_id, int *section_num,
-                                          int *position)
+struct item_location
+{
+	int section_num;
+	GSequenceIter *iter;
+};
+
+static void index_add(DBusMenuModel *menu, uint item_id, int section_num, GSequenceIter *iter)
+{
+	// First occurrence wins, as it was with linear search
+	if (g_hash_table_contains(menu->item_index, GUINT_TO_POINTER(item_id)))
+		return;
+	struct item_location *location = g_new0(struct item_location, 1);
+	location->section_num          = section_num;
+	location->iter                 = iter;
+	g_hash_table_insert(menu->item_index, GUINT_TO_POINTER(item_id), location);
+}
+
+// Items are only added, replaced and removed by layout_parse, so index is rebuilt after it.
+// Section numbers are stable until next rebuild, positions are taken from iters on lookup.
+static void dbus_menu_model_rebuild_index(DBusMenuModel *menu)
 {
+	g_hash_table_remove_all(menu->item_index);
+	int section_num = 0;
 	for (GSequenceIter *iter = g_sequence_get_begin_iter(menu->sections);
 	     !g_sequence_iter_is_end(iter);
-	     iter = g_sequence_iter_next(iter))
+	     iter = g_sequence_iter_next(iter), section_num++)
 	{
 		DBusMenuItem *current_section = (DBusMenuItem *)g_sequence_get(iter);
-		int current_section_num       = g_sequence_iter_get_position(iter);
-		if (current_section->id == item_id && current_section_num > 0)
-		{
-			*section_num = -1;
-			*position    = current_section_num;
-			return current_section;
-		}
+		// First section is not a real item, it has an id of parent
+		if (section_num > 0)
+			index_add(menu, current_section->id, -1, iter);
 		DBusMenuSectionModel *smodel = DBUS_MENU_SECTION_MODEL(
 		    g_hash_table_lookup(current_section->links, G_MENU_LINK_SECTION));
-		if (g_menu_model_get_n_items(G_MENU_MODEL(smodel)) == 0)
-			return NULL;
 		for (GSequenceIter *siter = g_sequence_get_begin_iter(smodel->items);
 		     !g_sequence_iter_is_end(siter);
 		     siter = g_sequence_iter_next(siter))
 		{
 			DBusMenuItem *current_item = (DBusMenuItem *)g_sequence_get(siter);
-			int current_num            = g_sequence_iter_get_position(siter);
-			if (current_item->id == item_id)
-			{
-				*section_num = current_section_num;
-				*position    = current_num;
-				return current_item;
-			}
+			index_add(menu, current_item->id, section_num, siter);
 		}
 	}
-	return NULL;
+}
+
+static DBusMenuItem *dbus_menu_model_find(DBusMenuModel *menu, uint item_id, int *section_num,
+                                          int *position)
+{
+	struct item_location *location =
+	    (struct item_location *)g_hash_table_lookup(menu->item_index,
+	                                                GUINT_TO_POINTER(item_id));
+	if (location == NULL)
+		return NULL;
+	// Sections are reported as position in top-level model
+	*section_num = location->section_num;
+	*position    = g_sequence_iter_get_position(location->iter);
+	return (DBusMenuItem *)g_sequence_get(location->iter);
+}
+
+// Items loaded in this menu and all its submenus, for memory accounting of cached menus
+G_GNUC_INTERNAL uint dbus_menu_model_count_items(DBusMenuModel *menu)
+{
+	g_return_val_if_fail(DBUS_MENU_IS_MODEL(menu), 0);
+	uint count = 0;
+	GHashTableIter iter;
+	gpointer value;
+	g_hash_table_iter_init(&iter, menu->item_index);
+	while (g_hash_table_iter_next(&iter, NULL, &value))
+	{
+		struct item_location *location = (struct item_location *)value;
+		count++;
+		if (location->section_num < 0)
+			continue;
+		DBusMenuItem *item = (DBusMenuItem *)g_sequence_get(location->iter);
+		if (item->action_type != DBUS_MENU_ACTION_SUBMENU)
+			continue;
+		DBusMenuModel *submenu = DBUS_MENU_MODEL(
+		    g_hash_table_lookup(item->links,
+		                        item->enabled ? G_MENU_LINK_SUBMENU
+		                                      : DBUS_MENU_DISABLED_SUBMENU));
+		if (DBUS_MENU_IS_MODEL(submenu))
+			count += dbus_menu_model_count_items(submenu);
+	}
+	return count;
 }
 
 static void dbus_menu_model_init(DBusMenuModel *menu)
@@ -708,9 +938,14 @@ static void dbus_menu_model_init(DBusMenuModel *menu)
 	menu->cancellable               = g_cancellable_new();
 	menu->parent_id                 = UINT_MAX;
 	menu->sections                  = g_sequence_new(dbus_menu_item_free);
+	menu->item_index =
+	    g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
 	menu->layout_update_required    = true;
 	menu->layout_update_in_progress = false;
+	menu->layout_request_pending    = false;
+	menu->layout_update_queued      = false;
 	menu->current_revision          = 0;
+	menu->queued_revision           = 0;
 }
 
 static void dbus_menu_model_constructed(GObject *object)
@@ -733,6 +968,7 @@ static void dbus_menu_model_finalize(GObject *object)
 		g_signal_handlers_disconnect_by_data(menu->xml, menu);
 	g_cancellable_cancel(menu->cancellable);
 	g_clear_object(&menu->cancellable);
+	g_clear_pointer(&menu->item_index, g_hash_table_destroy);
 	g_clear_pointer(&menu->sections, g_sequence_free);
 
 	G_OBJECT_CLASS(dbus_menu_model_parent_class)->finalize(object);
@@ -26,13 +26,25 @@
 G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE(DBusMenuModel, dbus_menu_model, DBUS_MENU, MODEL, GMenuModel)
+
+// Answers of a remote app, to find slow or hung menus
+typedef struct
+{
+	uint requests;
+	uint slow_requests;
+	uint timed_out_requests;
+	gint64 max_latency;
+} DBusMenuStats;
+
 G_GNUC_INTERNAL DBusMenuModel *dbus_menu_model_new(uint parent_id, DBusMenuModel *parent,
                                                    DBusMenuXml *xml, GActionGroup *action_group);
 G_GNUC_INTERNAL void dbus_menu_model_update_layout(DBusMenuModel *menu);
-G_GNUC_INTERNAL void dbus_menu_model_update_layout_sync(DBusMenuModel *menu);
+G_GNUC_INTERNAL void dbus_menu_model_about_to_show(DBusMenuModel *menu);
 G_GNUC_INTERNAL bool dbus_menu_model_is_layout_update_required(DBusMenuModel *model);
 G_GNUC_INTERNAL void dbus_menu_model_set_layout_update_required(DBusMenuModel *model,
                                                                 bool required);
+G_GNUC_INTERNAL const DBusMenuStats *dbus_menu_model_get_stats(DBusMenuModel *menu);
+G_GNUC_INTERNAL uint dbus_menu_model_count_items(DBusMenuModel *menu);
 
 G_END_DECLS
 
@@ -29,13 +29,14 @@ static void activate_ordinary_cb(GSimpleAction *action, GVariant *parameter, gpo
 	u_int32_t id;
 	sscanf(g_action_get_name(G_ACTION(action)), ACTION_PREFIX "%u", &id);
 	// use CURRENT_TIME instead of gtk_get_current_event_time to avoid linking to GTK.
-	dbus_menu_xml_call_event_sync(xml,
-	                              id,
-	                              "clicked",
-	                              g_variant_new("v", g_variant_new_int32(0)),
-	                              CURRENT_TIME,
-	                              NULL,
-	                              NULL);
+	dbus_menu_xml_call_event(xml,
+	                         id,
+	                         "clicked",
+	                         g_variant_new("v", g_variant_new_int32(0)),
+	                         CURRENT_TIME,
+	                         NULL,
+	                         NULL,
+	                         NULL);
 }
 
 static void activate_checkbox_cb(GSimpleAction *action, GVariant *parameter, gpointer user_data)
@@ -45,13 +46,14 @@ static void activate_checkbox_cb(GSimpleAction *action, GVariant *parameter, gpo
 	sscanf(g_action_get_name(G_ACTION(action)), ACTION_PREFIX "%u", &id);
 	g_autoptr(GVariant) state = g_action_get_state(G_ACTION(action));
 	// use CURRENT_TIME instead of gtk_get_current_event_time to avoid linking to GTK.
-	dbus_menu_xml_call_event_sync(xml,
-	                              id,
-	                              "clicked",
-	                              g_variant_new("v", g_variant_new_int32(0)),
-	                              CURRENT_TIME,
-	                              NULL,
-	                              NULL);
+	dbus_menu_xml_call_event(xml,
+	                         id,
+	                         "clicked",
+	                         g_variant_new("v", g_variant_new_int32(0)),
+	                         CURRENT_TIME,
+	                         NULL,
+	                         NULL,
+	                         NULL);
 	g_action_change_state(G_ACTION(action),
 	                      g_variant_new_boolean(!g_variant_get_boolean(state)));
 }
@@ -63,13 +65,14 @@ static void state_radio_cb(GSimpleAction *action, GVariant *parameter, gpointer
 	uint id;
 	sscanf(id_str, ACTION_PREFIX "%u", &id);
 	// use CURRENT_TIME instead of gtk_get_current_event_time to avoid linking to GTK.
-	dbus_menu_xml_call_event_sync(xml,
-	                              id,
-	                              "clicked",
-	                              g_variant_new("v", g_variant_new_int32(0)),
-	                              CURRENT_TIME,
-	                              NULL,
-	                              NULL);
+	dbus_menu_xml_call_event(xml,
+	                         id,
+	                         "clicked",
+	                         g_variant_new("v", g_variant_new_int32(0)),
+	                         CURRENT_TIME,
+	                         NULL,
+	                         NULL,
+	                         NULL);
 	g_simple_action_set_state(action, parameter);
 }
 
@@ -112,38 +115,16 @@ static void state_submenu_cb(GSimpleAction *action, GVariant *parameter, gpointe
 {
 	g_return_if_fail(DBUS_MENU_IS_MODEL(user_data));
 	DBusMenuModel *model = DBUS_MENU_MODEL(user_data);
-	DBusMenuXml *xml;
-	u_int32_t id;
-	g_object_get(model, "parent-id", &id, "xml", &xml, NULL);
-	bool request_open = g_variant_get_boolean(parameter);
-	GVariant *statev  = g_action_get_state(action);
-	bool opened       = g_variant_get_boolean(statev);
+	bool request_open    = g_variant_get_boolean(parameter);
+	GVariant *statev     = g_action_get_state(action);
+	bool opened          = g_variant_get_boolean(statev);
 	g_variant_unref(statev);
-	bool need_update = true;
 	if (request_open && !opened)
 	{
-		// Use opened before actual open. For Firefox.
-		dbus_menu_xml_call_event_sync(xml,
-		                              id,
-		                              "opened",
-		                              g_variant_new("v", g_variant_new_int32(0)),
-		                              CURRENT_TIME,
-		                              NULL,
-		                              NULL);
-		dbus_menu_xml_call_about_to_show_sync(xml,
-		                                      id,
-		                                      (gboolean *)&need_update,
-		                                      NULL,
-		                                      NULL);
-		if (g_menu_model_get_n_items(model) == 0)
-			need_update = true;
-		need_update = need_update || dbus_menu_model_is_layout_update_required(model);
-		if (need_update)
-		{
-			// TODD: Populate layout after request;
-			if (DBUS_MENU_IS_MODEL(model))
-				dbus_menu_model_update_layout(model);
-		}
+		if (g_menu_model_get_n_items(G_MENU_MODEL(model)) == 0)
+			dbus_menu_model_set_layout_update_required(model, true);
+		// Layout is requested after remote answers, without blocking the main loop
+		dbus_menu_model_about_to_show(model);
 		g_simple_action_set_state(action, g_variant_new_boolean(true));
 		// TODO: change state to false after menu closing, not by time
 		//                g_timeout_add(500, (GSourceFunc)source_state_false, action);
@@ -151,8 +132,7 @@ static void state_submenu_cb(GSimpleAction *action, GVariant *parameter, gpointe
 	else if (request_open)
 	{
 		g_simple_action_set_state(action, g_variant_new_boolean(true));
-		need_update = dbus_menu_model_is_layout_update_required(model);
-		if (need_update)
+		if (dbus_menu_model_is_layout_update_required(model))
 		{
 			// TODD: Populate layout after request;
 			if (DBUS_MENU_IS_MODEL(model))
@@ -161,13 +141,19 @@ static void state_submenu_cb(GSimpleAction *action, GVariant *parameter, gpointe
 	}
 	else
 	{
-		dbus_menu_xml_call_event_sync(xml,
-		                              id,
-		                              "closed",
-		                              g_variant_new("v", g_variant_new_int32(0)),
-		                              CURRENT_TIME,
-		                              NULL,
-		                              NULL);
+		DBusMenuXml *xml = NULL;
+		u_int32_t id;
+		g_object_get(model, "parent-id", &id, "xml", &xml, NULL);
+		if (DBUS_MENU_IS_XML(xml))
+			dbus_menu_xml_call_event(xml,
+			                         id,
+			                         "closed",
+			                         g_variant_new("v", g_variant_new_int32(0)),
+			                         CURRENT_TIME,
+			                         NULL,
+			                         NULL,
+			                         NULL);
+		g_clear_object(&xml);
 		g_simple_action_set_state(action, g_variant_new_boolean(false));
 	}
 }
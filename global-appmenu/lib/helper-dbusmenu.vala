@@ -21,18 +21,97 @@ using Gtk;
 
 namespace Appmenu
 {
+    /* Importers of recently active windows, kept alive so their menus stay
+       loaded and up to date, and alt-tabbing back shows a ready menubar. */
+    internal class DBusMenuCache: Object
+    {
+        private const uint MAX_WINDOWS = 8;
+        private const uint MAX_ITEMS = 4096;
+        private class Entry
+        {
+            public string name;
+            public ObjectPath path;
+            public DBusMenu.Importer importer;
+            public Entry(string name, ObjectPath path)
+            {
+                this.name = name;
+                this.path = path;
+                this.importer = new DBusMenu.Importer(name,(string)path);
+            }
+        }
+        private HashTable<uint,Entry> entries;
+        /* Least recently used window first */
+        private Queue<uint> lru;
+        public DBusMenuCache()
+        {
+            entries = new HashTable<uint,Entry>(direct_hash,direct_equal);
+            lru = new Queue<uint>();
+        }
+        /* Returns importer of the window, reusing the cached one if the window
+           still exports the same menu */
+        public DBusMenu.Importer lookup(uint xid, string name, ObjectPath path)
+        {
+            var entry = entries.lookup(xid);
+            if (entry == null || entry.name != name || entry.path != path)
+            {
+                entry = new Entry(name,path);
+                entries.insert(xid,entry);
+            }
+            lru.remove(xid);
+            lru.push_tail(xid);
+            evict(xid);
+            return entry.importer;
+        }
+        /* Starts importing the menu of a window which is not active yet,
+           top-level submenus are preloaded by importer itself */
+        public void prefetch(uint xid, string name, ObjectPath path)
+        {
+            if (entries.contains(xid) || lru.get_length() >= MAX_WINDOWS)
+                return;
+            entries.insert(xid,new Entry(name,path));
+            lru.push_head(xid);
+        }
+        public void remove(uint xid)
+        {
+            entries.remove(xid);
+            lru.remove(xid);
+        }
+        /* Drops least recently used windows over the limits, but never the active one */
+        private void evict(uint active_xid)
+        {
+            uint n_items = 0;
+            entries.foreach((xid,entry)=>{
+                n_items += entry.importer.get_n_items();
+            });
+            while (lru.get_length() > 1 && (lru.get_length() > MAX_WINDOWS || n_items > MAX_ITEMS))
+            {
+                var xid = lru.pop_head();
+                var entry = entries.lookup(xid);
+                uint requests, slow_requests, timed_out_requests;
+                int64 max_latency;
+                entry.importer.get_stats(out requests, out slow_requests, out timed_out_requests, out max_latency);
+                debug("Evicting menu of window %u: %u items, %u requests, %u slow, %u timed out, max latency %"+int64.FORMAT+" ms",
+                      xid, entry.importer.get_n_items(), requests, slow_requests, timed_out_requests, max_latency / 1000);
+                n_items -= uint.min(n_items, entry.importer.get_n_items());
+                entries.remove(xid);
+            }
+        }
+    }
     internal class DBusMenuHelper: Helper
     {
         private DBusMenu.Importer importer = null;
         private Helper dbus_helper = null;
         private ulong connect_handler = 0;
-        public DBusMenuHelper(MenuWidget w, string name, ObjectPath path, string? title, DesktopAppInfo? info)
+        public DBusMenuHelper(MenuWidget w, DBusMenu.Importer importer, string name, string? title, DesktopAppInfo? info)
         {
             dbus_helper = new DBusAppMenu(w, title, name, info);
-            importer = new DBusMenu.Importer(name,(string)path);
+            this.importer = importer;
             connect_handler = Signal.connect(importer,"notify::model",(GLib.Callback)on_model_changed_cb,w);
+            /* Cached importer has its menu loaded already, and will not notify until it changes */
+            if (importer.model.get_n_items() > 0)
+                on_model_changed_cb(importer, null, w);
         }
-        private static void on_model_changed_cb(DBusMenu.Importer importer, GLib.ParamSpec pspec, MenuWidget w)
+        private static void on_model_changed_cb(DBusMenu.Importer importer, GLib.ParamSpec? pspec, MenuWidget w)
         {
             w.insert_action_group("dbusmenu",importer.action_group);
             w.set_menubar(importer.model);
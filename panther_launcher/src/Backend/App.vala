@@ -50,6 +50,16 @@ public class Panther.Backend.App : Object {
     public string generic_name { get; private set; default = ""; }
     public AppType app_type { get; private set; default = AppType.APP; }
 
+    // collation key of the name, computed once for sorting
+    public string sort_key {
+        get {
+            if (_sort_key == null)
+                _sort_key = name.collate_key ();
+            return _sort_key;
+        }
+    }
+    private string? _sort_key = null;
+
     public Synapse.Match? match { get; private set; default = null; }
     public Synapse.Match? target { get; private set; default = null; }
     public Gee.ArrayList<string> actions { get; private set; default = null; }
@@ -60,11 +70,15 @@ public class Panther.Backend.App : Object {
 
     // seconds to wait before retrying icon check
     private const int RECHECK_TIMEOUT = 2;
+    // shown if the icon of the app can't be found
+    private const string[] FALLBACK_ICONS = {"application-default-icon", "image-missing"};
     private bool check_icon_again = true;
     private int firstres = 0;
     private int secondres = 0;
     private int res = 0;
-    private LoadableIcon loadable_icon = null;
+    private Icon? gicon = null;
+    // only the newest icon request may set the icon
+    private uint icon_serial = 0;
 
     // for FDO Desktop Actions
     // see http://standards.freedesktop.org/desktop-entry-spec/desktop-entry-spec-latest.html#extra-actions
@@ -92,17 +106,17 @@ public class Panther.Backend.App : Object {
         message(firstres.to_string());*/
         if (info.get_icon () is ThemedIcon) {
             icon_name = (info.get_icon () as ThemedIcon).get_names ()[0].dup ();
+            gicon = icon_for_name (icon_name);
         } else if (info.get_icon () is LoadableIcon) {
-            loadable_icon = info.get_icon () as LoadableIcon;
-            icon = get_loadable_icon ();
+            gicon = info.get_icon ();
         } else {
             icon_name = "application-default-icon";
+            gicon = new ThemedIcon (icon_name);
         }
-        if (icon == null) {
-            update_icon ();
 
-            Panther.icon_theme.changed.connect (update_icon);
-        }
+        update_icon ();
+
+        Panther.icon_theme.changed.connect (update_icon);
     }
 
     public App.from_command (string command) {
@@ -113,6 +127,7 @@ public class Panther.Backend.App : Object {
         exec = command;
         desktop_id = command;
         icon_name = "system-run";
+        gicon = new ThemedIcon (icon_name);
 
         update_icon ();
 
@@ -129,6 +144,13 @@ public class Panther.Backend.App : Object {
         this.match = match;
         this.target = target;
 
+        // for contacts we can load the thumbnail because we expect it to be
+        // the avatar. For other types it'd be ridiculously small.
+        if (match.match_type == Synapse.MatchType.CONTACT && match.has_thumbnail)
+            gicon = new FileIcon (File.new_for_path (match.thumbnail_path));
+        else
+            gicon = icon_for_name (icon_name);
+
         update_icon ();
 
     }
@@ -138,144 +160,100 @@ public class Panther.Backend.App : Object {
     }
 
     public void update_icon () {
+        int size;
         if(Panther.settings.icon_size == 0)
         {
             /*if(res < 2000)
-              icon = load_icon (34);
+              size = 34;
             else if(res > 4000)
-              icon = load_icon (80);
+              size = 80;
             else*/
-              icon = load_icon (64);
+              size = 64;
         }
         else {
-            icon = load_icon (Panther.settings.icon_size);
+            size = Panther.settings.icon_size;
         }
 
-        icon_changed ();
-    }
-
-    private delegate void IconLoadFallback ();
-
-    private class IconLoadFallbackMethod {
-        public unowned IconLoadFallback load_icon;
+        var serial = ++icon_serial;
 
-        public IconLoadFallbackMethod (IconLoadFallback fallback) {
-            load_icon = fallback;
+        var cached = lookup_icon (size);
+        if (cached != null) {
+            icon = cached;
+            icon_changed ();
+            return;
         }
-    }
-
-    public Gdk.Pixbuf? load_icon (int size) {
-        if (app_type == AppType.SYNAPSE) {
-            try {
-                // for contacts we can load the thumbnail because we expect it to be
-                // the avatar. For other types it'd be ridiculously small.
-                if (match.match_type == Synapse.MatchType.CONTACT && match.has_thumbnail) {
-                    return new Gdk.Pixbuf.from_file_at_scale (match.thumbnail_path, size, size, true);
-                }
-
-                var icon = Icon.new_for_string (icon_name);
-                var info = Gtk.IconTheme.get_default ().lookup_by_gicon (icon,
-                    size, Gtk.IconLookupFlags.FORCE_SIZE);
 
-                if (info == null)
-                    throw new IconError.NOT_FOUND ("Not found");
-
-                return info.load_icon ();
-            } catch (Error e) {
-                warning ("Failed to load icon: %s\n", e.message);
-            }
-
-            try {
-                return Panther.icon_theme.load_icon ("application-default-icon",
-                    size, Gtk.IconLookupFlags.FORCE_SIZE);
-            } catch (Error e) {
-                critical (e.message);
-            }
+        // keep showing the old icon while the new one loads
+        if (icon == null || icon.width != size) {
+            icon = IconCache.get_default ().get_placeholder (size);
+            icon_changed ();
         }
 
-        Gdk.Pixbuf icon = null;
-        var flags = Gtk.IconLookupFlags.FORCE_SIZE;
+        load_icon.begin (size, null, (obj, result) => {
+            var pixbuf = load_icon.end (result);
+            if (pixbuf == null || serial != icon_serial)
+                return;
 
-        if (loadable_icon != null)
-            return get_loadable_icon ();
-
-        IconLoadFallbackMethod[] fallbacks = {
-            new IconLoadFallbackMethod (() => {
-                try {
-                    icon = Panther.icon_theme.load_icon (icon_name, size, flags);
-                } catch (Error e) {
-                    warning ("Could not load icon. Falling back to method 2");
-                }
-            }),
+            icon = pixbuf;
+            icon_changed ();
+        });
+    }
 
-            new IconLoadFallbackMethod (() => {
-                // Since the best method didn't work retry after some time
-                if (check_icon_again) {
-                    // only recheck once
-                    check_icon_again = false;
+    /**
+     * Returns the icon at the given size if it is already loaded.
+     */
+    public Gdk.Pixbuf? lookup_icon (int size) {
+        if (gicon == null)
+            return null;
 
-                    Timeout.add_seconds (RECHECK_TIMEOUT, () => {
-                        Panther.icon_theme.rescan_if_needed ();
-                        update_icon ();
-                        return false;
-                    });
-                }
-            }),
+        return IconCache.get_default ().lookup (gicon, size);
+    }
 
-            new IconLoadFallbackMethod (() => {
-                try {
-                    if (icon_name.last_index_of (".") > 0) {
-                        var name = icon_name[0:icon_name.last_index_of (".")];
-                        icon = Panther.icon_theme.load_icon (name, size, flags);
-                    }
-                } catch (Error e) {
-                    warning ("Could not load icon. Falling back to method 3");
-                }
-            }),
+    /**
+     * Loads the icon at the given size in the background, falling back to
+     * the default icons if it can't be found.
+     */
+    public async Gdk.Pixbuf? load_icon (int size, Cancellable? cancellable = null) {
+        var cache = IconCache.get_default ();
+
+        Gdk.Pixbuf? pixbuf = null;
+        if (gicon != null)
+            pixbuf = yield cache.load (gicon, size, cancellable);
+
+        if (pixbuf == null && app_type == AppType.APP && check_icon_again) {
+            // the icon might just have been installed, retry after some time,
+            // but only once
+            check_icon_again = false;
+
+            Timeout.add_seconds (RECHECK_TIMEOUT, () => {
+                Panther.icon_theme.rescan_if_needed ();
+                update_icon ();
+                return false;
+            });
+        }
 
-            new IconLoadFallbackMethod (() => {
-                try {
-                    icon = new Gdk.Pixbuf.from_file_at_scale (icon_name, size, size, false);
-                } catch (Error e) {
-                    warning ("Could not load icon. Falling back to method 4");
-                }
-            }),
-
-            new IconLoadFallbackMethod (() => {
-                try {
-                    icon = Panther.icon_theme.load_icon ("application-default-icon", size, flags);
-                 } catch (Error e) {
-                     warning ("Could not load icon. Falling back to method 5");
-                 }
-            }),
-
-            new IconLoadFallbackMethod (() => {
-                 try {
-                    icon = Panther.icon_theme.load_icon ("image-missing", size, flags);
-                 } catch (Error e) {
-                    error ("Could not find a fallback icon to load");
-                 }
-            })
-        };
-        foreach (IconLoadFallbackMethod fallback in fallbacks) {
-            fallback.load_icon ();
-            if (icon != null)
+        foreach (var fallback in FALLBACK_ICONS) {
+            if (pixbuf != null || (cancellable != null && cancellable.is_cancelled ()))
                 break;
+
+            pixbuf = yield cache.load (new ThemedIcon (fallback), size, cancellable);
         }
 
-        return icon;
+        return pixbuf;
     }
 
-    public Gdk.Pixbuf? get_loadable_icon () {
-        Gdk.Pixbuf? tmp_loadable_icon;
+    private static Icon? icon_for_name (string name) {
+        if (name == "")
+            return null;
+
+        if (Path.is_absolute (name))
+            return new FileIcon (File.new_for_path (name));
+
         try {
-            var icon_stream = loadable_icon.load (0, null, null);
-            tmp_loadable_icon = new Gdk.Pixbuf.from_stream_at_scale (icon_stream, Panther.settings.icon_size,
-                                                                     Panther.settings.icon_size, true, null);
+            return Icon.new_for_string (name);
         } catch (Error e) {
-            tmp_loadable_icon = null;
+            return new ThemedIcon (name);
         }
-        return tmp_loadable_icon;
     }
 
     public bool launch () {
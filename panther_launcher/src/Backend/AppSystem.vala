@@ -24,6 +24,8 @@ public class Panther.Backend.AppSystem : Object {
 
     private Gee.ArrayList<GMenu.TreeDirectory> categories = null;
     private Gee.HashMap<string, Gee.ArrayList<App>> apps = null;
+    // all apps sorted by name, built on demand and dropped when the menu changes
+    private Gee.List<App>? apps_by_name = null;
     private GMenu.Tree apps_menu = null;
 
 #if HAVE_ZEITGEIST
@@ -89,6 +91,7 @@ public class Panther.Backend.AppSystem : Object {
 
     private void update_apps () {
         apps.clear ();
+        apps_by_name = null;
         foreach (var cat in categories)
             apps.set (cat.get_name (), get_apps_by_category (cat));
     }
@@ -156,9 +159,17 @@ public class Panther.Backend.AppSystem : Object {
         return apps;
     }
 
-    public SList<App> get_apps_by_name () {
-        var sorted_apps = new SList<App> ();
-        string[] sorted_apps_execs = {};
+    /**
+     * Returns all apps without settings panels, sorted by name and without
+     * duplicates of the same command. The list is shared until the menu
+     * changes, so it must not be modified.
+     */
+    public Gee.List<App> get_apps_by_name () {
+        if (apps_by_name != null)
+            return apps_by_name;
+
+        var sorted_apps = new Gee.ArrayList<App> ();
+        var sorted_apps_execs = new Gee.HashSet<string> ();
 
         foreach (Gee.ArrayList<App> category in apps.values) {
             foreach (App app in category) {
@@ -167,14 +178,14 @@ public class Panther.Backend.AppSystem : Object {
                     && (GCC_PANEL_CATEGORY in app.categories))
                     continue;
 
-
-                if (!(app.exec in sorted_apps_execs)) {
-                    sorted_apps.insert_sorted_with_data (app, Utils.sort_apps_by_name);
-                    sorted_apps_execs += app.exec;
-                }
+                if (sorted_apps_execs.add (app.exec))
+                    sorted_apps.add (app);
             }
         }
 
-        return sorted_apps;
+        sorted_apps.sort (Utils.sort_apps_by_name);
+        apps_by_name = sorted_apps.read_only_view;
+
+        return apps_by_name;
     }
 }
@@ -0,0 +1,182 @@
+// -*- Mode: vala; indent-tabs-mode: nil; tab-width: 4 -*-
+//
+//  Copyright (C) 2026 Panther Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+namespace Panther.Backend {
+
+    /**
+     * Pixbufs of icons shared by all views, keyed by icon and size.
+     *
+     * Icons are decoded off the main loop. Icons which couldn't be found are
+     * remembered as well, so they aren't looked up again until the icon
+     * theme changes.
+     */
+    public class IconCache : Object {
+
+        private static IconCache? instance = null;
+
+        public static IconCache get_default () {
+            if (instance == null)
+                instance = new IconCache ();
+
+            return instance;
+        }
+
+        private class Waiter {
+            public SourceFunc callback;
+
+            public Waiter (owned SourceFunc callback) {
+                this.callback = (owned) callback;
+            }
+        }
+
+        private Gee.HashMap<string, Gdk.Pixbuf> pixbufs;
+        private Gee.HashSet<string> missing;
+        // requests waiting for an icon which is already being loaded
+        private Gee.HashMap<string, Gee.ArrayList<Waiter>> loading;
+        private Gee.HashMap<int, Gdk.Pixbuf> placeholders;
+
+        private IconCache () {
+            pixbufs = new Gee.HashMap<string, Gdk.Pixbuf> ();
+            missing = new Gee.HashSet<string> ();
+            loading = new Gee.HashMap<string, Gee.ArrayList<Waiter>> ();
+            placeholders = new Gee.HashMap<int, Gdk.Pixbuf> ();
+
+            Gtk.IconTheme.get_default ().changed.connect (() => {
+                pixbufs.clear ();
+                missing.clear ();
+            });
+        }
+
+        /**
+         * Returns the icon if it is already loaded, without blocking.
+         */
+        public Gdk.Pixbuf? lookup (Icon icon, int size) {
+            var key = get_key (icon, size);
+            if (key == null)
+                return null;
+
+            return pixbufs.get (key);
+        }
+
+        /**
+         * An empty pixbuf to show while the icon is loading.
+         */
+        public Gdk.Pixbuf get_placeholder (int size) {
+            var placeholder = placeholders.get (size);
+            if (placeholder == null) {
+                placeholder = new Gdk.Pixbuf (Gdk.Colorspace.RGB, true, 8, size, size);
+                placeholder.fill (0);
+                placeholders.set (size, placeholder);
+            }
+
+            return placeholder;
+        }
+
+        /**
+         * Loads the icon at the given size, or returns null if it can't be found.
+         */
+        public async Gdk.Pixbuf? load (Icon icon, int size, Cancellable? cancellable = null) {
+            var key = get_key (icon, size);
+            if (key == null)
+                return yield load_uncached (icon, size);
+
+            if (pixbufs.has_key (key))
+                return pixbufs.get (key);
+
+            if (key in missing)
+                return null;
+
+            var waiters = loading.get (key);
+            if (waiters != null) {
+                waiters.add (new Waiter (load.callback));
+                yield;
+            } else {
+                waiters = new Gee.ArrayList<Waiter> ();
+                loading.set (key, waiters);
+
+                // not cancelled on behalf of a single request, others might wait for it
+                var pixbuf = yield load_uncached (icon, size);
+                if (pixbuf != null)
+                    pixbufs.set (key, pixbuf);
+                else
+                    missing.add (key);
+
+                loading.unset (key);
+                foreach (var waiter in waiters)
+                    Idle.add ((owned) waiter.callback);
+            }
+
+            if (cancellable != null && cancellable.is_cancelled ())
+                return null;
+
+            return pixbufs.get (key);
+        }
+
+        private async Gdk.Pixbuf? load_uncached (Icon icon, int size) {
+            var flags = Gtk.IconLookupFlags.FORCE_SIZE;
+            var theme = Gtk.IconTheme.get_default ();
+
+            try {
+                var file_icon = icon as FileIcon;
+                if (file_icon != null) {
+                    var stream = yield file_icon.file.read_async ();
+                    return yield new Gdk.Pixbuf.from_stream_at_scale_async (stream, size, size, true);
+                }
+
+                var themed_icon = icon as ThemedIcon;
+                if (themed_icon != null) {
+                    var info = theme.lookup_by_gicon (themed_icon, size, flags);
+
+                    // some apps use a file name, like "foo.png", as icon name
+                    if (info == null) {
+                        var name = themed_icon.get_names ()[0];
+                        if (name.last_index_of (".") > 0)
+                            info = theme.lookup_icon (name[0:name.last_index_of (".")], size, flags);
+                    }
+
+                    if (info == null)
+                        return null;
+
+                    return yield info.load_icon_async ();
+                }
+
+                var loadable_icon = icon as LoadableIcon;
+                if (loadable_icon != null) {
+                    var stream = yield loadable_icon.load_async (size, null);
+                    return yield new Gdk.Pixbuf.from_stream_at_scale_async (stream, size, size, true);
+                }
+
+                var info = theme.lookup_by_gicon (icon, size, flags);
+                if (info != null)
+                    return yield info.load_icon_async ();
+            } catch (Error e) {
+                debug ("Could not load icon %s: %s", icon.to_string () ?? "", e.message);
+            }
+
+            return null;
+        }
+
+        private static string? get_key (Icon icon, int size) {
+            var name = icon.to_string ();
+            if (name == null)
+                return null;
+
+            return "%d:%s".printf (size, name);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+// -*- Mode: vala; indent-tabs-mode: nil; tab-width: 4 -*-
+//
+//  Copyright (C) 2026 Panther Developers
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+namespace Panther.Backend {
+
+    /**
+     * Runs the searches typed into the launcher, one at a time.
+     *
+     * A new query cancels the search in flight. Queries arriving while the
+     * cancelled search winds down just replace each other, so only the newest
+     * one is searched next and only its results are reported.
+     */
+    public class SearchSession : Object {
+
+        public signal void results_changed (Gee.List<Synapse.Match> matches, string text);
+
+        private SynapseSearch synapse;
+
+        private bool running = false;
+        private bool has_pending = false;
+        private string pending_text = "";
+        private Synapse.SearchMatch? pending_match = null;
+        private Synapse.Match? pending_target = null;
+
+        public SearchSession (SynapseSearch synapse) {
+            this.synapse = synapse;
+        }
+
+        public void request (string text, Synapse.SearchMatch? search_match = null,
+            Synapse.Match? target = null) {
+
+            pending_text = text;
+            pending_match = search_match;
+            pending_target = target;
+            has_pending = true;
+
+            if (running)
+                synapse.cancel ();
+            else
+                run.begin ();
+        }
+
+        public void cancel () {
+            has_pending = false;
+            pending_match = null;
+            pending_target = null;
+            synapse.cancel ();
+        }
+
+        private async void run () {
+            running = true;
+
+            while (has_pending) {
+                has_pending = false;
+                var text = pending_text;
+                var search_match = pending_match;
+                var target = pending_target;
+                pending_match = null;
+                pending_target = null;
+
+                Gee.List<Synapse.Match>? matches;
+                if (search_match != null) {
+                    search_match.search_source = target;
+                    matches = yield synapse.search (text, search_match);
+                } else {
+                    // show the results of the fast plugins without waiting for the slow ones
+                    matches = yield synapse.search (text, null, (partial_results) => {
+                        if (!has_pending)
+                            results_changed (partial_results, text);
+                    });
+                }
+
+                // null or outdated if a newer query superseded this one
+                if (matches != null && !has_pending)
+                    results_changed (matches, text);
+            }
+
+            running = false;
+        }
+    }
+}
@@ -46,23 +46,42 @@ namespace Panther.Backend {
             }
         }
 
-        public async Gee.List<Synapse.Match>? search (string text, Synapse.SearchProvider? provider = null) {
+        /**
+         * Searches the given provider, or all plugins if none is given.
+         *
+         * For the plugins, progress is called with the ranked results found so far
+         * while slower plugins are still searching. Starting a new search cancels
+         * the previous one, which then returns null.
+         */
+        public async Gee.List<Synapse.Match>? search (string text, Synapse.SearchProvider? provider = null,
+            owned Synapse.SearchProgressFunc? progress = null) {
 
             if (current_search != null)
                 current_search.cancel ();
 
-            if (provider == null)
-                provider = sink;
+            var cancellable = new Cancellable ();
+            current_search = cancellable;
 
-            var results = new Synapse.ResultSet ();
+            // more matches of a type than the search view shows are never needed
+            var results = new Synapse.ResultSet.with_limit (Widgets.SearchView.MAX_RESULTS);
 
             try {
-                return yield provider.search (text, Synapse.QueryFlags.ALL, results, current_search);
+                if (provider == null)
+                    return yield sink.search_progressive (text, Synapse.QueryFlags.ALL, results, (owned) progress, cancellable);
+
+                return yield provider.search (text, Synapse.QueryFlags.ALL, results, cancellable);
+            } catch (Synapse.SearchError.SEARCH_CANCELLED e) {
+                // superseded by a newer search
             } catch (Error e) { warning (e.message); }
 
             return null;
         }
 
+        public void cancel () {
+            if (current_search != null)
+                current_search.cancel ();
+        }
+
         public static Gee.List<Synapse.Match> find_actions_for_match (Synapse.Match match) {
             return sink.find_actions_for_match (match, null, Synapse.QueryFlags.ALL);
         }
@@ -129,31 +148,21 @@ namespace Panther.Backend {
                 return markup.printf (Markup.escape_text (pattern));
             }
 
-            var matchers = Synapse.Query.get_matchers_for_query (pattern, 0,
-                RegexCompileFlags.OPTIMIZE | RegexCompileFlags.CASELESS);
+            var matcher = new Synapse.FuzzyMatcher (pattern);
 
             string? highlighted = null;
-            foreach (var matcher in matchers) {
-                MatchInfo mi;
-                if (matcher.key.match (text, 0, out mi)) {
-                    int start_pos;
-                    int end_pos;
-                    int last_pos = 0;
-                    int cnt = mi.get_match_count ();
-                    StringBuilder res = new StringBuilder ();
-                    for (int i = 1; i < cnt; i++) {
-                        mi.fetch_pos (i, out start_pos, out end_pos);
-                        warn_if_fail (start_pos >= 0 && end_pos >= 0);
-                        res.append (Markup.escape_text (text.substring (last_pos, start_pos - last_pos)));
-                        last_pos = end_pos;
-                        res.append (Markup.printf_escaped ("<b>%s</b>", mi.fetch (i)));
-                        if (i == cnt - 1) {
-                            res.append (Markup.escape_text (text.substring (last_pos)));
-                        }
-                    }
-                    highlighted = res.str;
-                    break;
+            int score;
+            Synapse.MatchSpan[] spans;
+            if (matcher.match_with_spans (text, out score, out spans)) {
+                int last_pos = 0;
+                StringBuilder res = new StringBuilder ();
+                foreach (var span in spans) {
+                    res.append (Markup.escape_text (text.substring (last_pos, span.start - last_pos)));
+                    res.append (Markup.printf_escaped ("<b>%s</b>", text.substring (span.start, span.end - span.start)));
+                    last_pos = span.end;
                 }
+                res.append (Markup.escape_text (text.substring (last_pos)));
+                highlighted = res.str;
             }
 
             if (highlighted != null) {
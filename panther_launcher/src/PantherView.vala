@@ -126,12 +126,13 @@ namespace Panther {
         private Gee.ArrayList<GMenu.TreeDirectory> categories;
         public Gee.HashMap<string, Gee.ArrayList<Backend.App>> apps;
         public Gee.ArrayList<Backend.App> saved_apps;
-        public SList<Backend.App> app_name;
+        public Gee.List<Backend.App> app_name;
 
         private Modality modality;
         private bool can_trigger_hotcorner = true;
 
         private Backend.SynapseSearch synapse;
+        private Backend.SearchSession search_session;
 
         private bool saved_cat = false;
 
@@ -202,6 +203,7 @@ namespace Panther {
 
             app_system = new Backend.AppSystem ();
             synapse = new Backend.SynapseSearch ();
+            search_session = new Backend.SearchSession (synapse);
 
             categories = app_system.get_categories ();
             apps = app_system.get_apps ();
@@ -303,6 +305,9 @@ namespace Panther {
 
             // Create the "NORMAL_VIEW"
             grid_view = new Widgets.Grid (Panther.settings.rows, Panther.settings.columns);
+            grid_view.app_launched.connect (() => {
+                hide ();
+            });
             stack.add_named (grid_view, "normal");
 
             // Create the "CATEGORY_VIEW"
@@ -313,7 +318,10 @@ namespace Panther {
             search_view = new Widgets.SearchView (this);
             search_view.margin_end = 6;
             search_view.start_search.connect ((match, target) => {
-                search.begin (search_entry.text, match, target);
+                search (search_entry.text, match, target);
+            });
+            search_session.results_changed.connect ((matches, text) => {
+                search_view.set_results (matches, text);
             });
 
             stack.add_named (search_view, "search");
@@ -448,7 +456,7 @@ namespace Panther {
             search_entry.search_changed.connect (() => {
                 if (modality != Modality.SEARCH_VIEW)
                     set_modality (Modality.SEARCH_VIEW);
-                search.begin (search_entry.text);
+                search (search_entry.text);
             });
             search_entry.grab_focus ();
             search_entry.activate.connect (search_entry_activated);
@@ -920,12 +928,13 @@ namespace Panther {
             }
         }
 
-        private async void search (string text, Synapse.SearchMatch? search_match = null,
+        private void search (string text, Synapse.SearchMatch? search_match = null,
             Synapse.Match? target = null) {
 
             var stripped = text.strip ();
 
             if (stripped == "") {
+                search_session.cancel ();
                 // this code was making problems when selecting the currently searched text
                 // and immediately replacing it. In that case two async searches would be
                 // started and both requested switching from and to search view, which would
@@ -943,32 +952,12 @@ namespace Panther {
             if (modality != Modality.SEARCH_VIEW)
                 set_modality (Modality.SEARCH_VIEW);
 
-            Gee.List<Synapse.Match> matches;
-
-            if (search_match != null) {
-                search_match.search_source = target;
-                matches = yield synapse.search (text, search_match);
-            } else {
-                matches = yield synapse.search (text);
-            }
-
-            Idle.add (() => {
-                search_view.set_results (matches, text);
-                return false;
-            });
+            search_session.request (text, search_match, target);
 
         }
 
         public void populate_grid_view () {
-            grid_view.clear ();
-            foreach (Backend.App app in app_system.get_apps_by_name ()) {
-                var app_entry = new Widgets.AppEntry (app);
-                app_entry.app_launched.connect (() => {
-                    hide ();
-                });
-                grid_view.append (app_entry);
-                app_entry.show_all ();
-            }
+            grid_view.set_apps (app_system.get_apps_by_name ());
 
             stack.set_visible_child_name ("normal");
         }
@@ -21,7 +21,7 @@ namespace Panther {
     class Utils : GLib.Object {
 
         public static int sort_apps_by_name (Backend.App a, Backend.App b) {
-            return a.name.collate (b.name);
+            return strcmp (a.sort_key, b.sort_key);
         }
     }
 }
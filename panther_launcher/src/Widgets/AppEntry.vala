@@ -37,7 +37,8 @@ public class Panther.Widgets.AppEntry : Gtk.Button {
 
     private bool dragging = false; //prevent launching
 
-    private Backend.App application;
+    private Backend.App application = null;
+    private ulong icon_changed_id = 0;
 
     private Backend.AppSystem app_system;
 
@@ -56,30 +57,11 @@ public class Panther.Widgets.AppEntry : Gtk.Button {
         Gtk.drag_source_set (this, Gdk.ModifierType.BUTTON1_MASK, {dnd},
                              Gdk.DragAction.COPY);
 
-        desktop_id = app.desktop_id;
-        desktop_path = app.desktop_path;
-#if HAS_PLANK
-        desktop_uri = File.new_for_path (desktop_path).get_uri ();
-#endif
-
-        application = app;
-        app_name = app.name;
-        tooltip_text = app.description;
-        exec_name = app.exec;
         icon_size = Panther.settings.icon_size;
-        icon = app.icon;
 
         get_style_context ().add_class (Gtk.STYLE_CLASS_FLAT);
 
-        if (Panther.settings.font_size <= 0.001) {
-            app_label = new Gtk.Label (app_name);
-            app_label.use_markup = false;
-        } else {
-            var texto = "<span font_size=\"%d\">%s</span>".printf((int)(Panther.settings.font_size * 1000),app_name);
-            app_label = new Gtk.Label(null);
-            app_label.set_markup(texto);
-        }
-
+        app_label = new Gtk.Label (null);
         app_label.halign = Gtk.Align.CENTER;
         app_label.justify = Gtk.Justification.CENTER;
         app_label.set_line_wrap (true);
@@ -87,7 +69,7 @@ public class Panther.Widgets.AppEntry : Gtk.Button {
         app_label.set_single_line_mode (false);
         app_label.set_ellipsize (Pango.EllipsizeMode.END);
 
-        image = new Gtk.Image.from_pixbuf (icon);
+        image = new Gtk.Image ();
         image.icon_size = icon_size;
         image.margin_top = 12;
 
@@ -131,11 +113,43 @@ public class Panther.Widgets.AppEntry : Gtk.Button {
             sel.set_uris ({File.new_for_path (desktop_path).get_uri ()});
         });
 
-        app.icon_changed.connect (() => {
-            icon = app.icon;
+        set_app (app);
+    }
+
+    /**
+     * Shows the given app, entries are reused for other apps instead of
+     * creating new ones.
+     */
+    public void set_app (Backend.App app) {
+        if (application != null && icon_changed_id != 0)
+            application.disconnect (icon_changed_id);
+
+        desktop_id = app.desktop_id;
+        desktop_path = app.desktop_path;
+#if HAS_PLANK
+        desktop_uri = File.new_for_path (desktop_path).get_uri ();
+#endif
+
+        application = app;
+        app_name = app.name;
+        tooltip_text = app.description;
+        exec_name = app.exec;
+        icon = app.icon;
+
+        if (Panther.settings.font_size <= 0.001) {
+            app_label.use_markup = false;
+            app_label.label = app_name;
+        } else {
+            var texto = "<span font_size=\"%d\">%s</span>".printf((int)(Panther.settings.font_size * 1000),app_name);
+            app_label.set_markup(texto);
+        }
+
+        image.set_from_pixbuf (icon);
+
+        icon_changed_id = app.icon_changed.connect (() => {
+            icon = application.icon;
             image.set_from_pixbuf (icon);
         });
-
     }
 
     public override void get_preferred_width (out int minimum_width, out int natural_width) {
@@ -50,6 +50,9 @@ public class Panther.Widgets.CategoryView : Gtk.EventBox {
         category_switcher = new Sidebar ();
 
         app_view = new Widgets.Grid (view.rows, view.columns);
+        app_view.app_launched.connect (() => {
+            view.hide ();
+        });
 
         user_view = new UserView ();
 
@@ -118,32 +121,20 @@ public class Panther.Widgets.CategoryView : Gtk.EventBox {
       });
     }
 
-    private void add_app (Backend.App app) {
-        var app_entry = new AppEntry (app);
-        app_entry.app_launched.connect (() => {
-            view.hide ();
-            print("hide10\n");
-        });
-        app_view.append (app_entry);
-        app_view.show_all ();
-
-    }
-
     public void show_filtered_apps (string category) {
-        app_view.clear ();
+        var filtered_apps = new Gee.ArrayList<Backend.App> ();
         if(category=="All"){
-          foreach (Backend.App app in view.app_name)
-              add_app (app);
+            filtered_apps.add_all (view.app_name);
         }
         else if(category=="Saved"){
-            foreach(Backend.App app in view.saved_apps)
-              add_app (app);
+            filtered_apps.add_all (view.saved_apps);
         }
         else{
-          foreach (Backend.App app in view.apps[category])
-            add_app (app);
+            filtered_apps.add_all (view.apps[category]);
         }
 
+        app_view.set_apps (filtered_apps);
+        app_view.show_all ();
         current_position = 0;
 
     }
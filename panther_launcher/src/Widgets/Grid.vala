@@ -26,16 +26,25 @@ namespace Panther.Widgets {
         public int number;
     }
 
+    /**
+     * Pages of app entries.
+     *
+     * Only the visible page and its neighbours hold AppEntry widgets, they
+     * are taken from a pool and given back when the page goes out of reach,
+     * so the number of widgets doesn't grow with the number of apps.
+     */
     public class Grid : Gtk.Box {
 
         public Widgets.Switcher page_switcher;
 
-        private Gtk.Stack stack;
-        private Gtk.Grid current_grid;
-        private Gee.HashMap<int, Gtk.Grid> grids;
+        public signal void app_launched ();
 
-        private uint current_row = 0;
-        private uint current_col = 0;
+        private Gtk.Stack stack;
+        private Gee.ArrayList<Gtk.Grid> grids;
+        // entries of the realized pages, by page index
+        private Gee.HashMap<int, Gee.ArrayList<AppEntry>> realized;
+        private Gee.ArrayList<AppEntry> pool;
+        private Gee.ArrayList<Backend.App> apps;
 
         private Page page;
 
@@ -60,76 +69,167 @@ namespace Panther.Widgets {
             main_grid.add (page_switcher);
             add (main_grid);
 
-            grids = new Gee.HashMap<int, Gtk.Grid> (null, null);
-            create_new_grid ();
+            grids = new Gee.ArrayList<Gtk.Grid> ();
+            realized = new Gee.HashMap<int, Gee.ArrayList<AppEntry>> ();
+            pool = new Gee.ArrayList<AppEntry> ();
+            apps = new Gee.ArrayList<Backend.App> ();
+
+            stack.notify["visible-child"].connect (update_realized_pages);
+            // pages which slid out of view are released once the transition is done
+            stack.notify["transition-running"].connect (update_realized_pages);
+
+            update_n_pages ();
             go_to_number (1);
         }
 
         private void create_new_grid () {
             // Grid properties
-            current_grid = new Gtk.Grid ();
-            current_grid.expand = false;
-            current_grid.row_homogeneous = false;
-            current_grid.column_homogeneous = false;
-            current_grid.margin_start = 12;
-            current_grid.margin_end = 12;
-
-            current_grid.row_spacing = Pixels.ROW_SPACING;
-            current_grid.column_spacing = 0;
-            grids.set (page.number, current_grid);
-            stack.add_titled (current_grid, page.number.to_string (), page.number.to_string ());
+            var grid = new Gtk.Grid ();
+            grid.expand = false;
+            grid.row_homogeneous = false;
+            grid.column_homogeneous = false;
+            grid.margin_start = 12;
+            grid.margin_end = 12;
+
+            grid.row_spacing = Pixels.ROW_SPACING;
+            grid.column_spacing = 0;
+            grids.add (grid);
+            var number = grids.size.to_string ();
+            stack.add_titled (grid, number, number);
 
             // Fake grids in case there are not enough apps to fill the grid
-            current_grid.attach (new Gtk.Grid (), 0, 0, (int)page.columns, (int)page.rows);
+            grid.attach (new Gtk.Grid (), 0, 0, (int)page.columns, (int)page.rows);
+            grid.show ();
         }
 
-        public void append (Gtk.Widget widget) {
-            update_position ();
-
-            current_grid.attach (widget, (int)current_col, (int)current_row, 1, 1);
-            current_col++;
-            current_grid.show ();
+        private int get_page_size () {
+            return (int) (page.rows * page.columns);
         }
 
-        private void update_position () {
-            if (current_col == page.columns) {
-                current_col = 0;
-                current_row++;
-            }
+        // adds or removes pages at the end to fit the apps
+        private void update_n_pages () {
+            var n_pages = int.max (1, (apps.size + get_page_size () - 1) / get_page_size ());
 
-            if (current_row == page.rows) {
-                page.number++;
+            while (grids.size < n_pages)
                 create_new_grid ();
-                current_row = 0;
+
+            while (grids.size > n_pages) {
+                var grid = grids.remove_at (grids.size - 1);
+                release_page (grids.size);
+                grid.destroy ();
             }
+
+            page.number = n_pages;
         }
 
-        public void clear () {
-            foreach (Gtk.Grid grid in grids.values) {
-                foreach (Gtk.Widget widget in grid.get_children ()) {
-                    widget.destroy ();
+        /**
+         * Shows the given apps. If they are the same apps in the same order as
+         * before, the visible entries are just updated and the page is kept.
+         */
+        public void set_apps (Gee.Collection<Backend.App> new_apps) {
+            var old_apps = apps;
+            apps = new Gee.ArrayList<Backend.App> ();
+            apps.add_all (new_apps);
+
+            var same_order = old_apps.size == apps.size;
+            for (var i = 0; same_order && i < apps.size; i++)
+                same_order = old_apps[i].desktop_id == apps[i].desktop_id;
+
+            if (same_order) {
+                foreach (var entry in realized.entries) {
+                    var first = entry.key * get_page_size ();
+                    for (var i = 0; i < entry.value.size; i++)
+                        entry.value[i].set_app (apps[first + i]);
                 }
+                return;
+            }
 
-                grid.destroy ();
+            release_all_pages ();
+            update_n_pages ();
+            go_to_number (1);
+            update_realized_pages ();
+        }
+
+        private void update_realized_pages () {
+            if (grids.size == 0 || stack.get_visible_child_name () == null)
+                return;
+
+            var current = get_current_page () - 1;
+
+            if (!stack.transition_running) {
+                foreach (var index in realized.keys.to_array ()) {
+                    if (index < current - 1 || index > current + 1)
+                        release_page (index);
+                }
             }
 
-            grids.clear ();
-            current_row = 0;
-            current_col = 0;
-            page.number = 1;
-            create_new_grid ();
-            stack.set_visible_child (current_grid);
+            for (var index = int.max (0, current - 1); index <= current + 1 && index < grids.size; index++)
+                realize_page (index);
+        }
+
+        private void realize_page (int index) {
+            if (realized.has_key (index))
+                return;
+
+            var entries = new Gee.ArrayList<AppEntry> ();
+            var grid = grids[index];
+            var first = index * get_page_size ();
+            for (var i = 0; i < get_page_size () && first + i < apps.size; i++) {
+                var entry = take_entry (apps[first + i]);
+                grid.attach (entry, i % (int)page.columns, i / (int)page.columns, 1, 1);
+                entry.show_all ();
+                entries.add (entry);
+            }
+
+            realized[index] = entries;
+        }
+
+        private void release_page (int index) {
+            Gee.ArrayList<AppEntry> entries;
+            if (!realized.unset (index, out entries))
+                return;
+
+            foreach (var entry in entries) {
+                entry.get_parent ().remove (entry);
+                pool.add (entry);
+            }
+        }
+
+        private void release_all_pages () {
+            foreach (var index in realized.keys.to_array ())
+                release_page (index);
+        }
+
+        private AppEntry take_entry (Backend.App app) {
+            if (pool.size > 0) {
+                var entry = pool.remove_at (pool.size - 1);
+                entry.set_app (app);
+                return entry;
+            }
+
+            var entry = new AppEntry (app);
+            entry.app_launched.connect (() => {
+                app_launched ();
+            });
+            return entry;
+        }
+
+        public void clear () {
+            set_apps (new Gee.ArrayList<Backend.App> ());
         }
 
         public Gtk.Widget? get_child_at (int column, int row) {
-            var col = ((int)(column/page.columns))+1;
+            var index = column / (int)page.columns;
 
-            var grid = grids.get (col);
-            if (grid != null) {
-                return grid.get_child_at (column - (int)page.columns*(col-1), row) as Widgets.AppEntry;
-            } else {
+            var entries = realized.get (index);
+            if (entries == null)
                 return null;
-            }
+
+            var position = row * (int)page.columns + column - (int)page.columns * index;
+            if (row < 0 || row >= page.rows || position < 0 || position >= entries.size)
+                return null;
+
+            return entries[position];
         }
 
         public int get_page_columns () {
@@ -175,10 +275,16 @@ namespace Panther.Widgets {
         }
 
         public void resize (int rows, int columns) {
-            clear ();
+            release_all_pages ();
+            foreach (var grid in grids)
+                grid.destroy ();
+            grids.clear ();
+
             page.rows = rows;
             page.columns = columns;
-            page.number = 1;
+            update_n_pages ();
+            go_to_number (1);
+            update_realized_pages ();
         }
     }
 }
@@ -52,18 +52,31 @@ namespace Panther.Widgets {
             name_label.use_markup = true;
             ((Gtk.Misc) name_label).xalign = 0.0f;
 
-            icon = new Gtk.Image.from_pixbuf (app.load_icon (ICON_SIZE));
+            cancellable = new Cancellable ();
+
+            var pixbuf = app.lookup_icon (ICON_SIZE);
+            icon = new Gtk.Image.from_pixbuf (pixbuf ?? Backend.IconCache.get_default ().get_placeholder (ICON_SIZE));
+
+            var has_favicon = false;
+            if (pixbuf == null) {
+                app.load_icon.begin (ICON_SIZE, cancellable, (obj, res) => {
+                    var loaded = app.load_icon.end (res);
+                    if (loaded != null && !has_favicon && !cancellable.is_cancelled ())
+                        icon.set_from_pixbuf (loaded);
+                });
+            }
 
             // load a favicon if we're an internet page
             var uri_match = app.match as Synapse.UriMatch;
             if (uri_match != null && uri_match.uri.has_prefix ("http")) {
-                cancellable = new Cancellable ();
                 Backend.SynapseSearch.get_favicon_for_match.begin (uri_match,
                     ICON_SIZE, cancellable, (obj, res) => {
 
-                    var pixbuf = Backend.SynapseSearch.get_favicon_for_match.end (res);
-                    if (pixbuf != null)
-                        icon.set_from_pixbuf (pixbuf);
+                    var favicon = Backend.SynapseSearch.get_favicon_for_match.end (res);
+                    if (favicon != null) {
+                        has_favicon = true;
+                        icon.set_from_pixbuf (favicon);
+                    }
                 });
             }
 
@@ -21,7 +21,7 @@ using Gtk;
 namespace Panther.Widgets {
 
     public class SearchView : Gtk.ScrolledWindow {
-        const int MAX_RESULTS = 20;
+        public const int MAX_RESULTS = 20;
         const int MAX_RESULTS_BEFORE_LIMIT = 10;
 
         public signal void start_search (Synapse.SearchMatch search_match, Synapse.Match? target);
@@ -380,18 +380,14 @@ namespace Synapse
       }
       else
       {
-        var matchers = Query.get_matchers_for_query (query.query_string, 0,
-          RegexCompileFlags.OPTIMIZE | RegexCompileFlags.CASELESS);
+        var matcher = new FuzzyMatcher (query.query_string);
         foreach (var action in actions)
         {
           if (!action.valid_for_match (match)) continue;
-          foreach (var matcher in matchers)
+          int score;
+          if (matcher.match (action.title, out score))
           {
-            if (matcher.key.match (action.title))
-            {
-              results.add (action, matcher.value);
-              break;
-            }
+            results.add (action, score);
           }
         }
       }
@@ -37,6 +37,8 @@ namespace Synapse
   // don't move into a class, gir doesn't like it
   [CCode (has_target = false)]
   public delegate void PluginRegisterFunc ();
+
+  public delegate void SearchProgressFunc (Gee.List<Match> partial_results);
   
   public class DataSink : Object, SearchProvider
   {
@@ -277,6 +279,8 @@ namespace Synapse
 
     private bool plugins_loaded = false;
 
+    public signal void plugins_ready ();
+
     public signal void plugin_registered (Object plugin);
 
     protected void register_plugin (Object plugin)
@@ -355,6 +359,7 @@ namespace Synapse
       }
 
       plugins_loaded = true;
+      plugins_ready ();
     }
     
     /* This needs to be called right after instantiation,
@@ -442,16 +447,35 @@ namespace Synapse
                                          QueryFlags flags,
                                          ResultSet? dest_result_set,
                                          Cancellable? cancellable = null) throws SearchError
+    {
+      return yield search_progressive (query, flags, dest_result_set, null,
+                                       cancellable);
+    }
+
+    /* Like search (), but progress is called with the ranked results found
+     * so far whenever plugins finish while others are still searching, so
+     * fast in-memory results can be shown before the slow ones arrive.
+     * Plugins finishing in the same main loop iteration are reported once.
+     */
+    public async Gee.List<Match> search_progressive (string query,
+                                                     QueryFlags flags,
+                                                     ResultSet? dest_result_set,
+                                                     owned SearchProgressFunc? progress,
+                                                     Cancellable? cancellable = null) throws SearchError
     {
       // wait for our initialization
-      while (!plugins_loaded)
+      if (!plugins_loaded)
       {
-        Timeout.add (100, search.callback);
-        yield;
-        if (cancellable != null && cancellable.is_cancelled ())
+        ulong ready_id = plugins_ready.connect (() =>
         {
-          throw new SearchError.SEARCH_CANCELLED ("Cancelled");
-        }
+          search_progressive.callback ();
+        });
+        yield;
+        SignalHandler.disconnect (this, ready_id);
+      }
+      if (cancellable != null && cancellable.is_cancelled ())
+      {
+        throw new SearchError.SEARCH_CANCELLED ("Cancelled");
       }
       var q = Query (query_id++, query, flags);
       string query_stripped = query.strip ();
@@ -463,6 +487,7 @@ namespace Synapse
       // FIXME: this is probably useless, if async method finishes immediately,
       // it'll call complete_in_idle
       bool waiting = false;
+      uint progress_id = 0;
 
       foreach (var data_plugin in item_plugins)
       {
@@ -498,7 +523,23 @@ namespace Synapse
             }
           }
 
-          if (--search_size == 0 && waiting) search.callback ();
+          if (--search_size == 0)
+          {
+            if (waiting) search_progressive.callback ();
+          }
+          else if (progress != null && progress_id == 0)
+          {
+            // before the next frame is drawn
+            progress_id = Idle.add_full (Priority.HIGH_IDLE, () =>
+            {
+              progress_id = 0;
+              if (cancellable == null || !cancellable.is_cancelled ())
+              {
+                progress (current_result_set.get_sorted_list ());
+              }
+              return false;
+            });
+          }
         });
       }
       cancellables.reverse ();
@@ -514,6 +555,9 @@ namespace Synapse
       waiting = true;
       if (search_size > 0) yield;
 
+      // the complete results supersede any pending progress
+      if (progress_id != 0) Source.remove (progress_id);
+
       if (cancellable != null && cancellable.is_cancelled ())
       {
         throw new SearchError.SEARCH_CANCELLED ("Cancelled");
@@ -63,6 +63,12 @@ namespace Synapse
     public bool is_valid { get; private set; default = true; }
 
     public string[] mime_types = null;
+    public string[] keywords = null;
+
+    // desktop actions, the names are localized
+    public string[] action_ids = {};
+    public string[] action_names = {};
+    public string[] action_names_folded = {};
     
     private string? name_folded = null;
     public unowned string get_name_folded ()
@@ -75,6 +81,9 @@ namespace Synapse
 
     private static const string GROUP = "Desktop Entry";
 
+    // layout of a record in the snapshot of the DesktopFileService
+    public const string VARIANT_TYPE = "(sssssssbbuasasasas)";
+
     public DesktopFileInfo.for_keyfile (string path, KeyFile keyfile,
                                         string desktop_id)
     {
@@ -83,6 +92,56 @@ namespace Synapse
       init_from_keyfile (keyfile);
     }
 
+    public DesktopFileInfo.from_variant (Variant record)
+    {
+      Object (desktop_id: record.get_child_value (0).get_string (),
+              name: record.get_child_value (1).get_string (),
+              generic_name: record.get_child_value (2).get_string (),
+              icon_name: record.get_child_value (4).get_string (),
+              filename: record.get_child_value (5).get_string ());
+
+      comment = record.get_child_value (3).get_string ();
+      exec = record.get_child_value (6).get_string ();
+      needs_terminal = record.get_child_value (7).get_boolean ();
+      is_hidden = record.get_child_value (8).get_boolean ();
+      show_in = (EnvironmentType) record.get_child_value (9).get_uint32 ();
+      mime_types = record.get_child_value (10).dup_strv ();
+      keywords = record.get_child_value (11).dup_strv ();
+      action_ids = record.get_child_value (12).dup_strv ();
+      action_names = record.get_child_value (13).dup_strv ();
+
+      // a damaged snapshot must not make the actions inconsistent
+      if (action_names.length != action_ids.length)
+      {
+        action_ids = {};
+        action_names = {};
+      }
+      foreach (unowned string action_name in action_names)
+      {
+        action_names_folded += action_name.casefold ();
+      }
+    }
+
+    public Variant to_variant ()
+    {
+      return new Variant.tuple ({
+        new Variant.string (desktop_id),
+        new Variant.string (name),
+        new Variant.string (generic_name ?? ""),
+        new Variant.string (comment ?? ""),
+        new Variant.string (icon_name ?? ""),
+        new Variant.string (filename),
+        new Variant.string (exec),
+        new Variant.boolean (needs_terminal),
+        new Variant.boolean (is_hidden),
+        new Variant.uint32 ((uint32) show_in),
+        new Variant.strv (mime_types),
+        new Variant.strv (keywords),
+        new Variant.strv (action_ids),
+        new Variant.strv (action_names)
+      });
+    }
+
     private EnvironmentType parse_environments (string[] environments)
     {
       EnvironmentType result = 0;
@@ -155,6 +214,17 @@ namespace Synapse
         }
 
         comment = app_info.get_description () ?? "";
+        keywords = app_info.get_keywords ();
+
+        foreach (unowned string action in app_info.list_actions ())
+        {
+          var action_name = app_info.get_action_name (action);
+          if (action_name == null) continue;
+
+          action_ids += action;
+          action_names += action_name;
+          action_names_folded += action_name.casefold ();
+        }
 
         var icon = app_info.get_icon () ??
           new ThemedIcon ("application-default-icon");
@@ -218,6 +288,17 @@ namespace Synapse
     private Gee.Map<string, Gee.List<DesktopFileInfo> > exec_map;
     private Gee.Map<string, DesktopFileInfo> desktop_id_map;
     private Gee.MultiMap<string, string> mimetype_parent_map;
+
+    /* The parsed desktop files are kept in a snapshot, so the first query
+     * after startup doesn't have to wait until all of them are read again.
+     * It is stamped with the modification times of the scanned directories
+     * and reloaded in the background if any of them changed.
+     */
+    private const uint32 SNAPSHOT_VERSION = 1;
+    private const string SNAPSHOT_TYPE =
+      "(usuasa(sx)a(sssssssbbuasasasas)a(ss))";
+    private Variant? snapshot_stamps = null;
+    private string[] snapshot_dirs = {};
     
     construct
     {
@@ -246,6 +327,13 @@ namespace Synapse
       get_environment_type ();
       DesktopAppInfo.set_desktop_env (session_type_str);
 
+      if (load_snapshot ())
+      {
+        init_once.leave (true);
+        verify_snapshot.begin ();
+        return;
+      }
+
       Idle.add_full (Priority.LOW, initialize.callback);
       yield;
 
@@ -348,7 +436,9 @@ namespace Synapse
     
     private async void process_directory (File directory,
                                           string id_prefix,
-                                          Gee.Set<File> monitored_dirs)
+                                          Gee.Set<File> monitored_dirs,
+                                          Gee.Map<string, int64?> stamps,
+                                          Gee.List<DesktopFileInfo> desktop_files)
     {
       try
       {
@@ -367,6 +457,11 @@ namespace Synapse
           if (path == scanned_dir.get_path ()) return;
         }
         monitored_dirs.add (directory);
+        // stamp before reading, so changes during the scan outdate the snapshot
+        if (path != null && !stamps.has_key (path))
+        {
+          stamps[path] = yield get_modification_time (path);
+        }
         var enumerator = yield directory.enumerate_children_async (
           FileAttribute.STANDARD_NAME + "," + FileAttribute.STANDARD_TYPE,
           0, 0);
@@ -379,7 +474,8 @@ namespace Synapse
             // FIXME: this could cause too many open files error, or?
             var subdir = directory.get_child (name);
             var new_prefix = "%s%s-".printf (id_prefix, subdir.get_basename ());
-            yield process_directory (subdir, new_prefix, monitored_dirs);
+            yield process_directory (subdir, new_prefix, monitored_dirs,
+                                     stamps, desktop_files);
           }
           else
           {
@@ -387,7 +483,8 @@ namespace Synapse
             if (name.has_suffix ("synapse.desktop")) continue;
             if (name.has_suffix (".desktop"))
             {
-              yield load_desktop_file (directory.get_child (name), id_prefix);
+              yield load_desktop_file (directory.get_child (name), id_prefix,
+                                       desktop_files);
             }
           }
         }
@@ -404,25 +501,61 @@ namespace Synapse
       data_dirs += Environment.get_user_data_dir ();
 
       Gee.Set<File> desktop_file_dirs = new Gee.HashSet<File> ();
+      var desktop_files = new Gee.ArrayList<DesktopFileInfo> ();
+      var mime_parents = new Gee.HashMultiMap<string, string> ();
 
-      mimetype_parent_map.clear ();
+      // the subdirectories are stamped by process_directory ()
+      var stamps = new Gee.HashMap<string, int64?> ();
+      foreach (unowned string path in get_stamped_paths (new string[] {}))
+      {
+        stamps[path] = yield get_modification_time (path);
+      }
 
       foreach (unowned string data_dir in data_dirs)
       {
         string dir_path = Path.build_filename (data_dir, "applications", null);
         var directory = File.new_for_path (dir_path);
-        yield process_directory (directory, "", desktop_file_dirs);
+        yield process_directory (directory, "", desktop_file_dirs, stamps,
+                                 desktop_files);
         dir_path = Path.build_filename (data_dir, "mime", "subclasses");
-        yield load_mime_parents_from_file (dir_path);
+        yield load_mime_parents_from_file (dir_path, mime_parents);
       }
-      
+
+      // the previous files are served until the new ones are complete
+      set_desktop_files (desktop_files);
+      mimetype_parent_map = mime_parents;
       create_indices ();
 
+      string[] dirs = {};
+      foreach (File d in desktop_file_dirs) dirs += d.get_path ();
+      monitor_directories (dirs);
+
+      save_snapshot.begin (dirs, stamps);
+    }
+
+    private void set_desktop_files (Gee.List<DesktopFileInfo> desktop_files)
+    {
+      all_desktop_files = new Gee.ArrayList<DesktopFileInfo> ();
+      non_hidden_desktop_files = new Gee.ArrayList<DesktopFileInfo> ();
+
+      foreach (var dfi in desktop_files)
+      {
+        all_desktop_files.add (dfi);
+        if (!dfi.is_hidden && session_type in dfi.show_in)
+        {
+          non_hidden_desktop_files.add (dfi);
+        }
+      }
+    }
+
+    private void monitor_directories (string[] dirs)
+    {
       directory_monitors = new Gee.ArrayList<FileMonitor> ();
-      foreach (File d in desktop_file_dirs)
+      foreach (unowned string path in dirs)
       {
         try
         {
+          var d = File.new_for_path (path);
           FileMonitor monitor = d.monitor_directory (0, null);
           monitor.changed.connect (this.desktop_file_directory_changed);
           directory_monitors.add (monitor);
@@ -433,6 +566,199 @@ namespace Synapse
         }
       }
     }
+
+    private static string get_snapshot_file_name ()
+    {
+      return Path.build_filename (Environment.get_user_cache_dir (), "synapse",
+                                  "desktop-files.snapshot");
+    }
+
+    private static string get_snapshot_locale ()
+    {
+      // names, comments and keywords are localized
+      return string.joinv (":", Intl.get_language_names ());
+    }
+
+    // the paths whose modification times decide if the snapshot is current
+    private static string[] get_stamped_paths (string[] dirs)
+    {
+      string[] data_dirs = Environment.get_system_data_dirs ();
+      data_dirs += Environment.get_user_data_dir ();
+
+      string[] paths = {};
+      foreach (unowned string data_dir in data_dirs)
+      {
+        paths += Path.build_filename (data_dir, "applications", null);
+        paths += Path.build_filename (data_dir, "mime", "subclasses", null);
+      }
+      foreach (unowned string dir in dirs)
+      {
+        if (!(dir in paths)) paths += dir;
+      }
+
+      return paths;
+    }
+
+    private static async int64 get_modification_time (string path)
+    {
+      try
+      {
+        var info = yield File.new_for_path (path).query_info_async (
+          FileAttribute.TIME_MODIFIED + "," + FileAttribute.TIME_MODIFIED_USEC,
+          0, Priority.LOW);
+        return (int64) info.get_attribute_uint64 (FileAttribute.TIME_MODIFIED)
+          * 1000000 + info.get_attribute_uint32 (FileAttribute.TIME_MODIFIED_USEC);
+      }
+      catch (Error err)
+      {
+        return -1;
+      }
+    }
+
+    private bool load_snapshot ()
+    {
+      Variant snapshot;
+      try
+      {
+        var mapped = new MappedFile (get_snapshot_file_name (), false);
+        snapshot = new Variant.from_bytes (new VariantType (SNAPSHOT_TYPE),
+                                           mapped.get_bytes (), false);
+      }
+      catch (Error err)
+      {
+        return false;
+      }
+
+      if (snapshot.get_child_value (0).get_uint32 () != SNAPSHOT_VERSION ||
+          snapshot.get_child_value (1).get_string () != get_snapshot_locale () ||
+          snapshot.get_child_value (2).get_uint32 () != (uint32) session_type)
+      {
+        return false;
+      }
+
+      snapshot_dirs = snapshot.get_child_value (3).dup_strv ();
+      snapshot_stamps = snapshot.get_child_value (4);
+
+      var desktop_files = new Gee.ArrayList<DesktopFileInfo> ();
+      var iter = snapshot.get_child_value (5).iterator ();
+      Variant? record;
+      while ((record = iter.next_value ()) != null)
+      {
+        desktop_files.add (new DesktopFileInfo.from_variant (record));
+      }
+
+      var mime_parents = new Gee.HashMultiMap<string, string> ();
+      iter = snapshot.get_child_value (6).iterator ();
+      Variant? pair;
+      while ((pair = iter.next_value ()) != null)
+      {
+        mime_parents.set (pair.get_child_value (0).get_string (),
+                          pair.get_child_value (1).get_string ());
+      }
+
+      set_desktop_files (desktop_files);
+      mimetype_parent_map = mime_parents;
+      create_indices ();
+
+      Utils.Logger.debug (this, "Loaded %d desktop files from snapshot",
+                          desktop_files.size);
+      return true;
+    }
+
+    private async void verify_snapshot ()
+    {
+      Idle.add_full (Priority.LOW, verify_snapshot.callback);
+      yield;
+
+      var stamps = new Gee.HashMap<string, int64?> ();
+      var iter = snapshot_stamps.iterator ();
+      Variant? stamp;
+      while ((stamp = iter.next_value ()) != null)
+      {
+        stamps[stamp.get_child_value (0).get_string ()] =
+          stamp.get_child_value (1).get_int64 ();
+      }
+      snapshot_stamps = null;
+
+      bool current = true;
+      foreach (unowned string path in get_stamped_paths (snapshot_dirs))
+      {
+        int64? mtime = stamps[path];
+        int64 current_mtime = yield get_modification_time (path);
+        if (mtime == null || mtime != current_mtime)
+        {
+          current = false;
+          break;
+        }
+      }
+
+      if (current)
+      {
+        monitor_directories (snapshot_dirs);
+      }
+      else
+      {
+        debug ("Desktop file snapshot is outdated");
+        reload_started ();
+        yield reload_desktop_files ();
+      }
+    }
+
+    // the stamps have to be taken before the scan of the saved files
+    private async void save_snapshot (string[] dirs,
+                                      Gee.Map<string, int64?> stamps)
+    {
+      var builder = new VariantBuilder (new VariantType ("a(sx)"));
+      foreach (unowned string path in get_stamped_paths (dirs))
+      {
+        int64 mtime = stamps[path] ?? -1;
+        builder.add ("(sx)", path, mtime);
+      }
+      var stamps = builder.end ();
+
+      builder = new VariantBuilder (
+        new VariantType ("a" + DesktopFileInfo.VARIANT_TYPE));
+      foreach (var dfi in all_desktop_files)
+      {
+        builder.add_value (dfi.to_variant ());
+      }
+      var records = builder.end ();
+
+      builder = new VariantBuilder (new VariantType ("a(ss)"));
+      foreach (var mime in mimetype_parent_map.get_keys ())
+      {
+        foreach (var parent in mimetype_parent_map[mime])
+        {
+          builder.add ("(ss)", mime, parent);
+        }
+      }
+      var mime_parents = builder.end ();
+
+      var snapshot = new Variant.tuple ({
+        new Variant.uint32 (SNAPSHOT_VERSION),
+        new Variant.string (get_snapshot_locale ()),
+        new Variant.uint32 ((uint32) session_type),
+        new Variant.strv (dirs),
+        stamps,
+        records,
+        mime_parents
+      });
+
+      try
+      {
+        var file = File.new_for_path (get_snapshot_file_name ());
+        DirUtils.create_with_parents (file.get_parent ().get_path (), 0700);
+        string? etag;
+        yield file.replace_contents_bytes_async (snapshot.get_data_as_bytes (),
+                                                 null, false,
+                                                 FileCreateFlags.REPLACE_DESTINATION,
+                                                 null, out etag);
+      }
+      catch (Error err)
+      {
+        warning ("Unable to save desktop file snapshot: %s", err.message);
+      }
+    }
     
     private uint timer_id = 0;
 
@@ -458,14 +784,13 @@ namespace Synapse
     private async void reload_desktop_files ()
     {
       debug ("Reloading desktop files...");
-      all_desktop_files.clear ();
-      non_hidden_desktop_files.clear ();
       yield load_all_desktop_files ();
 
       reload_done ();
     }
 
-    private async void load_desktop_file (File file, string id_prefix)
+    private async void load_desktop_file (File file, string id_prefix,
+                                          Gee.List<DesktopFileInfo> desktop_files)
     {
       try
       {
@@ -484,11 +809,7 @@ namespace Synapse
                                                      desktop_id);
           if (dfi.is_valid)
           {
-            all_desktop_files.add (dfi);
-            if (!dfi.is_hidden && session_type in dfi.show_in)
-            {
-              non_hidden_desktop_files.add (dfi);
-            }
+            desktop_files.add (dfi);
           }
         }
       }
@@ -562,7 +883,8 @@ namespace Synapse
       }
     }
 
-    private async void load_mime_parents_from_file (string fi)
+    private async void load_mime_parents_from_file (string fi,
+                                                    Gee.MultiMap<string, string> mime_parents)
     {
       var file = File.new_for_path (fi);
       bool exists = yield Utils.query_exists_async (file);
@@ -585,7 +907,7 @@ namespace Synapse
           // cannot be parent of myself!
           if (mimes[0] == mimes[1]) continue;
           //debug ("Map %s -> %s", mimes[0], mimes[1]);
-          mimetype_parent_map.set (mimes[0], mimes[1]);
+          mime_parents.set (mimes[0], mimes[1]);
         } while (true);
       } catch (GLib.Error err) { /* can't read file */ }
     }
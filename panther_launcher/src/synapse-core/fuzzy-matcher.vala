@@ -0,0 +1,453 @@
+/*
+ * Copyright (C) 2026 Panther Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+namespace Synapse
+{
+  /**
+   * Byte range [start, end) of a text which matched a part of the query.
+   */
+  public struct MatchSpan
+  {
+    public int start;
+    public int end;
+  }
+
+  /**
+   * Case-insensitive subsequence matcher, in the spirit of fzf or Sublime.
+   *
+   * The characters of the query have to appear in the text in order, the
+   * first one (and the first one of every further word of the query) at the
+   * start of a word. Matched characters get a bonus if they start a word or
+   * a camel case hump or if they follow the previous match directly, gaps
+   * are penalized. The best alignment is found in O(query * text).
+   *
+   * Besides that, a query can match as plain substring or, with two or more
+   * words, with its words in any order. The scores are mapped to the range
+   * of Match.Score, so a text equal to the query gets Match.Score.HIGHEST
+   * and a prefix Match.Score.EXCELLENT.
+   */
+  public class FuzzyMatcher : Object
+  {
+    private const int SCORE_MATCH = 16;
+    private const int SCORE_GAP_START = -3;
+    private const int SCORE_GAP_EXTENSION = -1;
+    private const int BONUS_START = 10;
+    private const int BONUS_BOUNDARY = 8;
+    private const int BONUS_CAMEL = 7;
+    private const int BONUS_CONSECUTIVE = 4;
+    private const int BONUS_FIRST_CHAR_MULTIPLIER = 2;
+    private const int NONE = int.MIN / 2;
+
+    private MatcherFlags flags;
+    // lowercased query without whitespace
+    private unichar[] pattern;
+    // whether the character starts a word of the query
+    private bool[] pattern_word_start;
+    // lowercased query, whitespace collapsed
+    private unichar[] full_pattern;
+    private unichar[,] words;
+    private int[] word_lengths;
+    private int ideal_score;
+
+    // per text buffers, reused between calls
+    private unichar[] chars;
+    private int[] offsets;
+    private int[] bonus;
+    private int text_length;
+
+    // per query * text buffers of find_alignment (), reused between calls
+    private int[] score;
+    private int[] run_bonus;
+    private int[] back;
+
+    public FuzzyMatcher (string query, MatcherFlags flags = 0)
+    {
+      this.flags = flags;
+
+      string[] query_words = Regex.split_simple ("\\s+", query.strip ());
+      int longest = 0;
+      int count = 0;
+      foreach (unowned string word in query_words)
+      {
+        if (word == "") continue;
+        longest = int.max (longest, word.char_count ());
+        count++;
+      }
+
+      pattern = {};
+      pattern_word_start = {};
+      full_pattern = {};
+      words = new unichar[count, longest];
+      word_lengths = new int[count];
+
+      int w = 0;
+      foreach (unowned string word in query_words)
+      {
+        if (word == "") continue;
+        if (w > 0) full_pattern += ' ';
+
+        int index = 0;
+        unichar c;
+        bool first = true;
+        while (word.get_next_char (ref index, out c))
+        {
+          c = c.tolower ();
+          words[w, word_lengths[w]++] = c;
+          full_pattern += c;
+          pattern += c;
+          pattern_word_start += first;
+          first = false;
+        }
+        w++;
+      }
+
+      int m = pattern.length;
+      ideal_score = m * SCORE_MATCH + BONUS_START * BONUS_FIRST_CHAR_MULTIPLIER
+        + (m - 1) * BONUS_START;
+    }
+
+    /**
+     * Matches the text against the query.
+     *
+     * @param score the relevancy of the match, in the range of Match.Score
+     * @return whether the text matched
+     */
+    public bool match (string text, out int score)
+    {
+      MatchSpan[]? spans;
+      return run (text, false, out score, out spans);
+    }
+
+    /**
+     * Like match (), but also returns the byte ranges of the text which
+     * were matched, useful for highlighting.
+     */
+    public bool match_with_spans (string text, out int score,
+                                  out MatchSpan[] spans)
+    {
+      MatchSpan[]? result;
+      bool matched = run (text, true, out score, out result);
+      spans = result ?? new MatchSpan[0];
+      return matched;
+    }
+
+    private bool run (string text, bool with_spans, out int score,
+                      out MatchSpan[]? spans)
+    {
+      score = 0;
+      spans = null;
+
+      if (pattern.length == 0)
+      {
+        score = Match.Score.POOR;
+        return true;
+      }
+
+      prepare_text (text);
+      if (text_length < pattern.length) return false;
+
+      int[]? positions = null;
+      int raw = find_alignment (with_spans, out positions);
+
+      int[]? substring_positions = null;
+      int substring_raw = NONE;
+      if (!(MatcherFlags.NO_SUBSTRING in flags))
+      {
+        substring_raw = find_substring (with_spans, out substring_positions);
+      }
+      if (substring_raw > raw)
+      {
+        raw = substring_raw;
+        positions = (owned) substring_positions;
+      }
+
+      int penalty = 0;
+      if (raw == NONE && word_lengths.length >= 2
+          && !(MatcherFlags.NO_REVERSED in flags))
+      {
+        raw = find_words_any_order (with_spans, out positions);
+        penalty = Match.Score.INCREMENT_SMALL;
+      }
+
+      if (raw == NONE) return false;
+
+      if (is_exact_match ())
+      {
+        score = Match.Score.HIGHEST;
+      }
+      else
+      {
+        double quality = (double) raw / ideal_score;
+        quality = quality.clamp (0.0, 1.0);
+        score = Match.Score.POOR - penalty
+          + (int) ((Match.Score.EXCELLENT - Match.Score.POOR) * quality);
+      }
+
+      if (with_spans) spans = build_spans (positions);
+      return true;
+    }
+
+    private void prepare_text (string text)
+    {
+      int capacity = text.length;
+      if (chars == null || chars.length < capacity)
+      {
+        chars = new unichar[capacity];
+        offsets = new int[capacity + 1];
+        bonus = new int[capacity];
+      }
+
+      int index = 0;
+      int n = 0;
+      unichar c;
+      unichar prev = 0;
+      offsets[0] = 0;
+      while (text.get_next_char (ref index, out c))
+      {
+        if (n == 0)
+          bonus[n] = is_word_char (c) ? BONUS_START : 0;
+        else if (!is_word_char (prev) && is_word_char (c))
+          bonus[n] = BONUS_BOUNDARY;
+        else if (prev.islower () && c.isupper ())
+          bonus[n] = BONUS_CAMEL;
+        else
+          bonus[n] = 0;
+
+        chars[n] = c.tolower ();
+        offsets[++n] = index;
+        prev = c;
+      }
+      text_length = n;
+    }
+
+    /**
+     * Dynamic programming over the query and the text, score[i, j] is the
+     * best score of the first i + 1 query characters with the last one
+     * matched at position j of the text.
+     */
+    private int find_alignment (bool with_positions, out int[]? positions)
+    {
+      positions = null;
+
+      int m = pattern.length;
+      int n = text_length;
+      if (score == null || score.length < m * n)
+      {
+        score = new int[m * n];
+        run_bonus = new int[m * n];
+        back = new int[m * n];
+      }
+
+      bool fuzzy = !(MatcherFlags.NO_FUZZY in flags);
+      bool partial = !(MatcherFlags.NO_PARTIAL in flags);
+
+      for (int i = 0; i < m; i++)
+      {
+        unichar pc = pattern[i];
+        bool word_start = pattern_word_start[i];
+        int row = i * n;
+        int prev_row = row - n;
+
+        // best gapped predecessor ending before j - 1
+        int gap_best = NONE;
+        int gap_from = -1;
+
+        for (int j = 0; j < n; j++)
+        {
+          if (i > 0 && j >= 2)
+          {
+            int start = score[prev_row + j - 2];
+            if (gap_best != NONE) gap_best += SCORE_GAP_EXTENSION;
+            if (start != NONE && start + SCORE_GAP_START > gap_best)
+            {
+              gap_best = start + SCORE_GAP_START;
+              gap_from = j - 2;
+            }
+          }
+
+          score[row + j] = NONE;
+          if (chars[j] != pc) continue;
+          if (word_start && bonus[j] == 0) continue;
+
+          if (i == 0)
+          {
+            score[row + j] = SCORE_MATCH + bonus[j] * BONUS_FIRST_CHAR_MULTIPLIER;
+            run_bonus[row + j] = bonus[j];
+            if (with_positions) back[row + j] = -1;
+            continue;
+          }
+
+          int best = NONE;
+          if (!word_start && j > 0 && score[prev_row + j - 1] != NONE)
+          {
+            int b = int.max (bonus[j], int.max (run_bonus[prev_row + j - 1],
+                                                BONUS_CONSECUTIVE));
+            best = score[prev_row + j - 1] + SCORE_MATCH + b;
+            run_bonus[row + j] = run_bonus[prev_row + j - 1];
+            if (with_positions) back[row + j] = j - 1;
+          }
+
+          bool gap_allowed = word_start || fuzzy || (partial && bonus[j] > 0);
+          if (gap_allowed && gap_best != NONE
+              && gap_best + SCORE_MATCH + bonus[j] > best)
+          {
+            best = gap_best + SCORE_MATCH + bonus[j];
+            run_bonus[row + j] = bonus[j];
+            if (with_positions) back[row + j] = gap_from;
+          }
+
+          score[row + j] = best;
+        }
+      }
+
+      int last_row = (m - 1) * n;
+      int best = NONE;
+      int best_j = -1;
+      for (int j = 0; j < n; j++)
+      {
+        if (score[last_row + j] > best)
+        {
+          best = score[last_row + j];
+          best_j = j;
+        }
+      }
+
+      if (best != NONE && with_positions)
+      {
+        positions = new int[m];
+        int j = best_j;
+        for (int i = m - 1; i >= 0; i--)
+        {
+          positions[i] = j;
+          j = back[i * n + j];
+        }
+      }
+
+      return best;
+    }
+
+    private int find_substring (bool with_positions, out int[]? positions)
+    {
+      positions = null;
+
+      int m = full_pattern.length;
+      for (int j = 0; j + m <= text_length; j++)
+      {
+        int k = 0;
+        while (k < m && chars[j + k] == full_pattern[k]) k++;
+        if (k < m) continue;
+
+        if (with_positions)
+        {
+          positions = new int[m];
+          for (k = 0; k < m; k++) positions[k] = j + k;
+        }
+        return m * SCORE_MATCH + (m - 1) * BONUS_CONSECUTIVE
+          + bonus[j] * BONUS_FIRST_CHAR_MULTIPLIER;
+      }
+
+      return NONE;
+    }
+
+    /**
+     * Every word of the query has to start a word of the text, but their
+     * order doesn't matter.
+     */
+    private int find_words_any_order (bool with_positions, out int[]? positions)
+    {
+      positions = null;
+      int[] found = {};
+      int total = 0;
+
+      for (int w = 0; w < word_lengths.length; w++)
+      {
+        int length = word_lengths[w];
+        int start = -1;
+        for (int j = 0; j + length <= text_length && start < 0; j++)
+        {
+          if (bonus[j] == 0) continue;
+
+          int k = 0;
+          while (k < length && chars[j + k] == words[w, k]) k++;
+          if (k == length) start = j;
+        }
+        if (start < 0) return NONE;
+
+        total += length * SCORE_MATCH + bonus[start]
+          + (length - 1) * int.max (bonus[start], BONUS_CONSECUTIVE);
+        if (with_positions)
+        {
+          for (int k = 0; k < length; k++) found += start + k;
+        }
+      }
+
+      if (with_positions)
+      {
+        // spans are built from ascending positions
+        for (int i = 1; i < found.length; i++)
+        {
+          int value = found[i];
+          int k = i - 1;
+          for (; k >= 0 && found[k] > value; k--) found[k + 1] = found[k];
+          found[k + 1] = value;
+        }
+        positions = found;
+      }
+
+      return total;
+    }
+
+    private bool is_exact_match ()
+    {
+      if (text_length != full_pattern.length) return false;
+      for (int j = 0; j < text_length; j++)
+      {
+        if (chars[j] != full_pattern[j]) return false;
+      }
+      return true;
+    }
+
+    private MatchSpan[] build_spans (int[]? positions)
+    {
+      MatchSpan[] spans = {};
+      if (positions == null) return spans;
+
+      foreach (int j in positions)
+      {
+        int start = offsets[j];
+        int end = offsets[j + 1];
+        if (spans.length > 0 && spans[spans.length - 1].end >= start)
+        {
+          spans[spans.length - 1].end = int.max (spans[spans.length - 1].end, end);
+        }
+        else
+        {
+          spans += MatchSpan () { start = start, end = end };
+        }
+      }
+
+      return spans;
+    }
+
+    private static bool is_word_char (unichar c)
+    {
+      // same semantics as \b of GRegex
+      return c.isalnum () || c == '_';
+    }
+  }
+}
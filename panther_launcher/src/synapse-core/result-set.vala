@@ -20,102 +20,254 @@
 
 namespace Synapse
 {
-  public class ResultSet : Object, Gee.Traversable<Match>, Gee.Iterable <Gee.Map.Entry <Match, int>>
+  /**
+   * Collects matches together with their relevancy.
+   *
+   * The matches of every MatchType are kept in a min-heap, so a set with a
+   * limit replaces its worst match of that type in O(log limit) when a better
+   * one arrives and never holds more than it can present. Adding a match
+   * again, or another UriMatch with the same uri, keeps the higher relevancy,
+   * on a tie the match added first stays.
+   */
+  public class ResultSet : Object, Gee.Traversable<Match>
   {
-    protected Gee.Map<Match, int> matches;
-    protected Gee.Set<unowned string> uris;
+    private class Heap
+    {
+      public Match[] matches = {};
+      public int[] relevancies = {};
+      public int size = 0;
+    }
+
+    // maximum number of matches per MatchType, 0 for no limit
+    public int limit { get; construct; default = 0; }
+
+    private Gee.Map<int, Heap> heaps;
+    // position of every match in the heap of its type
+    private Gee.Map<Match, int> positions;
+    // Match.uri is not owned, so we can optimize here
+    private Gee.Map<unowned string, Match> uris;
+    private int count = 0;
 
     public ResultSet ()
     {
       Object ();
     }
 
+    public ResultSet.with_limit (int limit)
+    {
+      Object (limit: limit);
+    }
+
     construct
     {
-      matches = new Gee.HashMap<Match, int> ();
-      // Match.uri is not owned, so we can optimize here
-      uris = new Gee.HashSet<unowned string> ();
+      heaps = new Gee.HashMap<int, Heap> ();
+      positions = new Gee.HashMap<Match, int> ();
+      uris = new Gee.HashMap<unowned string, Match> ();
     }
 
     public Type element_type
     {
-      get { return matches.element_type; }
+      get { return typeof (Match); }
     }
 
     public int size
     {
-      get { return matches.size; }
+      get { return count; }
     }
 
-    public Gee.Set<Match> keys
+    public bool foreach (Gee.ForallFunc<Match> func)
     {
-      owned get { return matches.keys; }
+      foreach (var heap in heaps.values)
+      {
+        for (int i = 0; i < heap.size; i++)
+        {
+          if (!func (heap.matches[i])) return false;
+        }
+      }
+      return true;
     }
 
-    public Gee.Set<Gee.Map.Entry <Match, int>> entries
+    public void add (Match match, int relevancy)
     {
-      owned get { return matches.entries; }
+      var heap = heaps[match.match_type];
+      if (heap == null)
+      {
+        heap = new Heap ();
+        heaps[match.match_type] = heap;
+      }
+
+      if (positions.has_key (match))
+      {
+        int i = positions[match];
+        if (relevancy <= heap.relevancies[i]) return;
+        heap.relevancies[i] = relevancy;
+        sift_down (heap, i);
+        return;
+      }
+
+      unowned string? uri = get_uri (match);
+      Match? existing = uri != null ? uris[uri] : null;
+      if (existing != null)
+      {
+        int i = positions[existing];
+        if (relevancy <= heaps[existing.match_type].relevancies[i]) return;
+      }
+
+      // removing an existing match of the same type makes room already
+      bool evict = limit > 0 && heap.size >= limit &&
+                   (existing == null || existing.match_type != match.match_type);
+      // the root is the worst match of this type, decide before dropping
+      // the existing match so a rejected match doesn't lose both
+      if (evict && !is_worse (heap.matches[0], heap.relevancies[0], match, relevancy))
+        return;
+
+      if (existing != null)
+      {
+        remove_at (heaps[existing.match_type], positions[existing]);
+      }
+      if (evict) remove_at (heap, 0);
+
+      int i = heap.size++;
+      if (i == heap.matches.length)
+      {
+        heap.matches += match;
+        heap.relevancies += relevancy;
+      }
+      else
+      {
+        heap.matches[i] = match;
+        heap.relevancies[i] = relevancy;
+      }
+      positions[match] = i;
+      if (uri != null) uris[uri] = match;
+      count++;
+
+      sift_up (heap, i);
     }
 
-    public Gee.Iterator<Gee.Map.Entry <Match, int>?> iterator ()
+    public void add_all (ResultSet? rs)
     {
-      return matches.iterator ();
+      if (rs == null) return;
+      foreach (var heap in rs.heaps.values)
+      {
+        for (int i = 0; i < heap.size; i++)
+        {
+          add (heap.matches[i], heap.relevancies[i]);
+        }
+      }
     }
 
-    public bool foreach (Gee.ForallFunc<Match> func)
+    public bool contains_uri (string uri)
     {
-        return matches.keys.foreach (func);
+      return uris.has_key (uri);
     }
 
-    public void add (Match match, int relevancy)
+    public Gee.List<Match> get_sorted_list ()
     {
-      matches.set (match, relevancy);
-
-      if (match is UriMatch)
+      var sorted_list = new Gee.ArrayList<Match> ();
+      foreach (var heap in heaps.values)
       {
-        unowned string uri = (match as UriMatch).uri;
-        if (uri != null && uri != "")
+        for (int i = 0; i < heap.size; i++)
         {
-          uris.add (uri);
+          sorted_list.add (heap.matches[i]);
         }
       }
+
+      sorted_list.sort ((a, b) =>
+      {
+        int ra = heaps[a.match_type].relevancies[positions[a]];
+        int rb = heaps[b.match_type].relevancies[positions[b]];
+        return compare (a, ra, b, rb);
+      });
+
+      return sorted_list;
     }
 
-    public void add_all (ResultSet? rs)
+    private static unowned string? get_uri (Match match)
     {
-      if (rs == null) return;
-      matches.set_all (rs.matches);
-      uris.add_all (rs.uris);
+      if (!(match is UriMatch)) return null;
+      unowned string uri = (match as UriMatch).uri;
+      return uri != null && uri != "" ? uri : null;
     }
 
-    public bool contains_uri (string uri)
+    // negative if a comes first in the sorted list
+    private static int compare (Match a, int relevancy_a, Match b, int relevancy_b)
     {
-      return uri in uris;
+      int relevancy_delta = relevancy_b - relevancy_a;
+      if (relevancy_delta != 0) return relevancy_delta;
+      // FIXME: utf8 compare!
+      else return a.title.ascii_casecmp (b.title);
     }
 
-    public Gee.List<Match> get_sorted_list ()
+    private static bool is_worse (Match a, int relevancy_a, Match b, int relevancy_b)
     {
-      var l = new Gee.ArrayList<Gee.Map.Entry<Match, int>> ();
-      l.add_all (matches.entries);
+      return compare (a, relevancy_a, b, relevancy_b) > 0;
+    }
 
-      l.sort ((a, b) => 
+    private void remove_at (Heap heap, int i)
+    {
+      var match = heap.matches[i];
+      positions.unset (match);
+      unowned string? uri = get_uri (match);
+      if (uri != null) uris.unset (uri);
+      count--;
+
+      int last = --heap.size;
+      if (i != last)
       {
-        unowned Gee.Map.Entry<Match, int> e1 = (Gee.Map.Entry<Match, int>) a;
-        unowned Gee.Map.Entry<Match, int> e2 = (Gee.Map.Entry<Match, int>) b;
-        int relevancy_delta = e2.value - e1.value;
-        if (relevancy_delta != 0) return relevancy_delta;
-        // FIXME: utf8 compare!
-        else return e1.key.title.ascii_casecmp (e2.key.title);
-      });
+        move (heap, last, i);
+        sift_up (heap, i);
+        sift_down (heap, positions[heap.matches[i]]);
+      }
+      heap.matches[last] = null;
+    }
 
-      var sorted_list = new Gee.ArrayList<Match> ();
-      foreach (Gee.Map.Entry<Match, int> m in l)
+    private void move (Heap heap, int from, int to)
+    {
+      heap.matches[to] = heap.matches[from];
+      heap.relevancies[to] = heap.relevancies[from];
+      positions[heap.matches[to]] = to;
+    }
+
+    private void sift_up (Heap heap, int i)
+    {
+      var match = heap.matches[i];
+      int relevancy = heap.relevancies[i];
+      while (i > 0)
       {
-        sorted_list.add (m.key);
+        int parent = (i - 1) / 2;
+        if (!is_worse (match, relevancy,
+                       heap.matches[parent], heap.relevancies[parent])) break;
+        move (heap, parent, i);
+        i = parent;
       }
+      heap.matches[i] = match;
+      heap.relevancies[i] = relevancy;
+      positions[match] = i;
+    }
 
-      return sorted_list;
+    private void sift_down (Heap heap, int i)
+    {
+      var match = heap.matches[i];
+      int relevancy = heap.relevancies[i];
+      while (true)
+      {
+        int child = 2 * i + 1;
+        if (child >= heap.size) break;
+        if (child + 1 < heap.size &&
+            is_worse (heap.matches[child + 1], heap.relevancies[child + 1],
+                      heap.matches[child], heap.relevancies[child]))
+        {
+          child++;
+        }
+        if (!is_worse (heap.matches[child], heap.relevancies[child],
+                       match, relevancy)) break;
+        move (heap, child, i);
+        i = child;
+      }
+      heap.matches[i] = match;
+      heap.relevancies[i] = relevancy;
+      positions[match] = i;
     }
   }
 }
-
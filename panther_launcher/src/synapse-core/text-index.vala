@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2026 Panther Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+namespace Synapse
+{
+  /**
+   * In-memory index over the casefolded strings of a fixed set of documents,
+   * which are identified by their position.
+   *
+   * Titles of a document are matched fuzzily (e.g. "\bq.*u.*e"), its other
+   * texts only by substring or prefix. find_candidates () returns a superset
+   * of the documents a FuzzyMatcher for the query could match:
+   *  - all bytes of the query (but whitespace) need to be contained,
+   *  - and either every trigram of the query's words is contained,
+   *  - or the first byte of the query starts a word in one of the titles.
+   *
+   * If the query only grew since the last lookup, the previous candidates
+   * are narrowed instead of starting over.
+   */
+  public class TextIndex : Object
+  {
+    private int document_count;
+    private int bitset_length;
+
+    // per byte value, bitsets of the documents containing it
+    private uint64[] byte_bits;
+    // per byte value, bitsets of the documents with a title word starting with it
+    private uint64[] initial_bits;
+    // per packed trigram, sorted ids of the documents containing it
+    private Gee.HashMap<int, Gee.ArrayList<int>> trigrams;
+
+    private string? last_query = null;
+    private uint64[] last_contained;
+    private uint64[] last_substring;
+
+    public TextIndex (int document_count)
+    {
+      this.document_count = document_count;
+      bitset_length = (document_count + 63) / 64;
+
+      byte_bits = new uint64[256 * bitset_length];
+      initial_bits = new uint64[256 * bitset_length];
+      trigrams = new Gee.HashMap<int, Gee.ArrayList<int>> ();
+    }
+
+    public int get_document_count ()
+    {
+      return document_count;
+    }
+
+    /**
+     * Adds the strings of a document, documents need to be added in
+     * ascending order of their ids.
+     */
+    public void add_document (int id, string?[] titles, string?[] texts)
+      requires (id >= 0 && id < document_count)
+    {
+      foreach (unowned string? title in titles)
+      {
+        if (title != null) add_text (id, title, true);
+      }
+      foreach (unowned string? text in texts)
+      {
+        if (text != null) add_text (id, text, false);
+      }
+
+      last_query = null;
+    }
+
+    private void add_text (int id, string text, bool is_title)
+    {
+      bool after_word = false;
+      int prev1 = -1;
+      int prev2 = -1;
+
+      for (int i = 0; i < text.length; i++)
+      {
+        uint8 b = text.data[i];
+        set_bit (byte_bits, b, id);
+
+        // same semantics as \b of a non-unicode GRegex
+        bool is_word = is_word_byte (b);
+        if (is_title && is_word && !after_word) set_bit (initial_bits, b, id);
+        after_word = is_word;
+
+        if (is_space_byte (b))
+        {
+          prev1 = prev2 = -1;
+          continue;
+        }
+
+        if (prev2 >= 0) add_trigram (pack_trigram (prev2, prev1, b), id);
+        prev2 = prev1;
+        prev1 = b;
+      }
+    }
+
+    private void add_trigram (int trigram, int id)
+    {
+      var ids = trigrams[trigram];
+      if (ids == null)
+      {
+        ids = new Gee.ArrayList<int> ();
+        trigrams[trigram] = ids;
+      }
+      else if (ids[ids.size - 1] == id)
+      {
+        return;
+      }
+      ids.add (id);
+    }
+
+    /**
+     * Returns the ids of all documents which might match the given query.
+     *
+     * @param query the casefolded query
+     * @param fuzzy whether fuzzy and partial matchers are used for titles
+     */
+    public int[] find_candidates (string query, bool fuzzy = true)
+    {
+      int start = 0;
+      uint64[] contained;
+      uint64[] substring;
+
+      if (last_query != null && query.has_prefix (last_query))
+      {
+        start = last_query.length;
+        contained = last_contained;
+        substring = last_substring;
+      }
+      else
+      {
+        contained = new uint64[bitset_length];
+        substring = new uint64[bitset_length];
+        fill_bitset (contained);
+        fill_bitset (substring);
+      }
+
+      // narrow by the bytes and trigrams which were added to the query
+      int prev1 = -1;
+      int prev2 = -1;
+      for (int i = 0; i < query.length; i++)
+      {
+        uint8 b = query.data[i];
+        if (is_space_byte (b))
+        {
+          prev1 = prev2 = -1;
+          continue;
+        }
+
+        if (i >= start)
+        {
+          and_bitset (contained, byte_bits, b * bitset_length);
+          if (prev2 >= 0) and_postings (substring, pack_trigram (prev2, prev1, b));
+        }
+        prev2 = prev1;
+        prev1 = b;
+      }
+      and_bitset (substring, contained, 0);
+
+      // fuzzy matchers need the first character to start a word
+      int first = 0;
+      while (first < query.length && is_space_byte (query.data[first])) first++;
+
+      uint64[] initial = new uint64[bitset_length];
+      if (first < query.length && is_word_byte (query.data[first]))
+      {
+        int offset = query.data[first] * bitset_length;
+        for (int i = 0; i < bitset_length; i++)
+          initial[i] = initial_bits[offset + i] & contained[i];
+      }
+      else if (first < query.length)
+      {
+        // can't rule out a preceding \b, keep everything
+        for (int i = 0; i < bitset_length; i++)
+          initial[i] = contained[i];
+      }
+
+      last_query = query;
+      last_contained = contained;
+      last_substring = substring;
+
+      int[] result = {};
+      for (int i = 0; i < bitset_length; i++)
+      {
+        uint64 word = substring[i];
+        if (fuzzy) word |= initial[i];
+
+        while (word != 0)
+        {
+          int bit = count_trailing_zeros (word);
+          result += i * 64 + bit;
+          word &= word - 1;
+        }
+      }
+
+      return result;
+    }
+
+    private void and_postings (uint64[] bitset, int trigram)
+    {
+      var ids = trigrams[trigram];
+      var mask = new uint64[bitset_length];
+      if (ids != null)
+      {
+        foreach (int id in ids)
+          mask[id / 64] |= (uint64) 1 << (id % 64);
+      }
+      and_bitset (bitset, mask, 0);
+    }
+
+    private void fill_bitset (uint64[] bitset)
+    {
+      for (int i = 0; i < bitset_length; i++)
+        bitset[i] = uint64.MAX;
+
+      // clear the bits past the last document
+      int rest = document_count % 64;
+      if (rest != 0) bitset[bitset_length - 1] = ((uint64) 1 << rest) - 1;
+    }
+
+    private void and_bitset (uint64[] bitset, uint64[] other, int offset)
+    {
+      for (int i = 0; i < bitset_length; i++)
+        bitset[i] &= other[offset + i];
+    }
+
+    private void set_bit (uint64[] bitsets, uint8 b, int id)
+    {
+      bitsets[b * bitset_length + id / 64] |= (uint64) 1 << (id % 64);
+    }
+
+    private static int count_trailing_zeros (uint64 word)
+    {
+      int count = 0;
+      while ((word & 1) == 0)
+      {
+        word >>= 1;
+        count++;
+      }
+      return count;
+    }
+
+    private static int pack_trigram (int b1, int b2, int b3)
+    {
+      return (b1 << 16) | (b2 << 8) | b3;
+    }
+
+    private static bool is_word_byte (uint8 b)
+    {
+      return ((char) b).isalnum () || b == '_';
+    }
+
+    private static bool is_space_byte (uint8 b)
+    {
+      return ((char) b).isspace ();
+    }
+  }
+}
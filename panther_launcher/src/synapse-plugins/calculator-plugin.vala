@@ -50,12 +50,199 @@ namespace Synapse
       public Result (double result, string match_string)
       {
         Object (match_type: MatchType.TEXT,
-                title: "%g".printf (result),
-                description: "%s = %g".printf (match_string, result),
+                title: "%.12g".printf (result),
+                description: "%s = %.12g".printf (match_string, result),
                 has_thumbnail: false, icon_name: "accessories-calculator");
       }
     }
 
+    public class Config : ConfigObject
+    {
+      // hand expressions which can't be evaluated internally over to bc
+      public bool use_bc { get; set; default = false; }
+    }
+
+    /**
+     * Recursive descent parser for arithmetic expressions, which evaluates
+     * while parsing:
+     *
+     *   expression := term (("+" | "-") term)*
+     *   term       := unary (("*" | "/" | "%") unary)*
+     *   unary      := ("-" | "+") unary | power
+     *   power      := primary ("^" unary)?
+     *   primary    := number | constant | function "(" expression ")"
+     *                 | "(" expression ")"
+     *
+     * Parentheses which aren't closed yet are closed at the end of the
+     * input, as the user is probably still typing.
+     */
+    private class Evaluator
+    {
+      private string input;
+      private int pos;
+      // number of operators and functions, a plain number isn't a calculation
+      private int operations;
+
+      public bool evaluate (string input, out double result)
+      {
+        this.input = input;
+        pos = 0;
+        operations = 0;
+
+        if (!parse_expression (out result)) return false;
+        return pos == input.length && operations > 0 && result.is_finite ();
+      }
+
+      private char peek ()
+      {
+        return pos < input.length ? input[pos] : '\0';
+      }
+
+      private bool parse_expression (out double result)
+      {
+        if (!parse_term (out result)) return false;
+
+        while (peek () == '+' || peek () == '-')
+        {
+          char op = input[pos++];
+          double rhs;
+          if (!parse_term (out rhs)) return false;
+
+          result = op == '+' ? result + rhs : result - rhs;
+          operations++;
+        }
+
+        return true;
+      }
+
+      private bool parse_term (out double result)
+      {
+        if (!parse_unary (out result)) return false;
+
+        while (peek () == '*' || peek () == '/' || peek () == '%')
+        {
+          char op = input[pos++];
+          double rhs;
+          if (!parse_unary (out rhs)) return false;
+
+          if (op == '*') result *= rhs;
+          else if (op == '/') result /= rhs;
+          else result = Math.fmod (result, rhs);
+          operations++;
+        }
+
+        return true;
+      }
+
+      private bool parse_unary (out double result)
+      {
+        if (peek () == '-' || peek () == '+')
+        {
+          char op = input[pos++];
+          if (!parse_unary (out result)) return false;
+
+          if (op == '-') result = -result;
+          return true;
+        }
+
+        return parse_power (out result);
+      }
+
+      private bool parse_power (out double result)
+      {
+        if (!parse_primary (out result)) return false;
+
+        if (peek () == '^')
+        {
+          pos++;
+          double exponent;
+          if (!parse_unary (out exponent)) return false;
+
+          result = Math.pow (result, exponent);
+          operations++;
+        }
+
+        return true;
+      }
+
+      private bool parse_primary (out double result)
+      {
+        result = 0.0;
+        char c = peek ();
+
+        if (c == '(')
+        {
+          pos++;
+          if (!parse_expression (out result)) return false;
+          if (peek () == ')') pos++;
+          else if (pos < input.length) return false;
+          return true;
+        }
+
+        if (c.isdigit () || c == '.') return parse_number (out result);
+        if (c.isalpha ()) return parse_identifier (out result);
+
+        return false;
+      }
+
+      private bool parse_number (out double result)
+      {
+        int start = pos;
+        bool has_point = false;
+        while (peek ().isdigit () || (peek () == '.' && !has_point))
+        {
+          if (peek () == '.') has_point = true;
+          pos++;
+        }
+
+        string number = input.substring (start, pos - start);
+        result = double.parse (number);
+        return number != ".";
+      }
+
+      private bool parse_identifier (out double result)
+      {
+        result = 0.0;
+        int start = pos;
+        while (peek ().isalpha ()) pos++;
+        string name = input.substring (start, pos - start);
+
+        switch (name)
+        {
+          case "pi":
+            result = Math.PI;
+            return true;
+          case "e":
+            result = Math.E;
+            return true;
+        }
+
+        if (peek () != '(') return false;
+
+        double arg;
+        if (!parse_primary (out arg)) return false;
+        operations++;
+
+        switch (name)
+        {
+          case "sqrt": result = Math.sqrt (arg); break;
+          case "sin": result = Math.sin (arg); break;
+          case "cos": result = Math.cos (arg); break;
+          case "tan": result = Math.tan (arg); break;
+          case "asin": result = Math.asin (arg); break;
+          case "acos": result = Math.acos (arg); break;
+          case "atan": result = Math.atan (arg); break;
+          case "exp": result = Math.exp (arg); break;
+          case "ln": result = Math.log (arg); break;
+          case "log": result = Math.log10 (arg); break;
+          case "abs": result = Math.fabs (arg); break;
+          default: return false;
+        }
+
+        return true;
+      }
+    }
+
     static void register_plugin ()
     {
       DataSink.PluginRegistry.get_default ().register_plugin (
@@ -63,9 +250,7 @@ namespace Synapse
         _ ("Calculator"),
         _ ("Calculate basic expressions."),
         "accessories-calculator",
-        register_plugin,
-        Environment.find_program_in_path ("bc") != null,
-        _ ("bc is not installed")
+        register_plugin
       );
     }
 
@@ -74,7 +259,13 @@ namespace Synapse
       register_plugin ();
     }
 
+    private const int MAX_CACHED_RESULTS = 64;
+
     private Regex regex;
+    private Config config;
+    private Evaluator evaluator;
+    // results of the last inputs, NAN for inputs which aren't expressions
+    private Gee.HashMap<string, double?> cache;
 
     construct
     {
@@ -82,6 +273,7 @@ namespace Synapse
          check for pairs of parantheses to be used correctly and only whitespace-stripped strings
          will match. Basically it matches strings of the form: 
          "paratheses_open* number (operator paratheses_open* number paratheses_close*)+"
+         It is only used to decide what to pass to bc.
       */
       try
       {
@@ -90,6 +282,11 @@ namespace Synapse
       } catch (Error e) {
         Utils.Logger.error (this, "Error creating regexp.");
       }
+
+      config = (Config) ConfigService.get_default ().bind_config ("plugins", "calculator-plugin",
+                                                                  typeof (Config));
+      evaluator = new Evaluator ();
+      cache = new Gee.HashMap<string, double?> ();
     }
     
     public bool handles_query (Query query)
@@ -99,53 +296,81 @@ namespace Synapse
 
     public async ResultSet? search (Query query) throws SearchError
     { 
-      string input = query.query_string.replace (" ", "").replace (",", ".");
+      string input = query.query_string.replace (" ", "").replace (",", ".").down ();
+
+      double d = evaluate (input);
+      if (d.is_nan () && input.length > 1)
+      {
+        // the user is probably in the middle of typing an operator
+        d = evaluate (input[0 : input.length - 1]);
+      }
+
+      if (d.is_nan () && config.use_bc)
+      {
+        d = yield solve_with_bc (input, query.cancellable);
+      }
+
+      query.check_cancellable ();
+      if (d.is_nan ()) return null;
+
+      ResultSet results = new ResultSet ();
+      results.add (new Result (d, query.query_string), Match.Score.AVERAGE);
+      return results;
+    }
+
+    private double evaluate (string input)
+    {
+      double? cached = cache[input];
+      if (cached != null) return cached;
+
+      double result;
+      if (!evaluator.evaluate (input, out result)) result = double.NAN;
+
+      if (cache.size >= MAX_CACHED_RESULTS) cache.clear ();
+      cache[input] = result;
+
+      return result;
+    }
+
+    private async double solve_with_bc (string input, Cancellable? cancellable)
+    {
       bool matched = regex.match (input);
       if (!matched && input.length > 1)
       {
         input = input[0 : input.length - 1];
         matched = regex.match (input);
       }
-      if (matched)
+      if (!matched || Environment.find_program_in_path ("bc") == null)
       {
-        Pid pid;
-        int read_fd, write_fd;
-        string[] argv = {"bc", "-l"};
-        string? solution = null;
+        return double.NAN;
+      }
 
-        try
-        {
-          Process.spawn_async_with_pipes (null, argv, null,
-                                          SpawnFlags.SEARCH_PATH,
-                                          null, out pid, out write_fd, out read_fd);
-          UnixInputStream read_stream = new UnixInputStream (read_fd, true);
-          DataInputStream bc_output = new DataInputStream (read_stream);
-
-          UnixOutputStream write_stream = new UnixOutputStream (write_fd, true);
-          DataOutputStream bc_input = new DataOutputStream (write_stream);
-
-          bc_input.put_string (input + "\n", query.cancellable);
-          yield bc_input.close_async (Priority.DEFAULT, query.cancellable);
-          solution = yield bc_output.read_line_async (Priority.DEFAULT_IDLE, query.cancellable);
-
-          if (solution != null)
-          {
-            double d = double.parse (solution);
-            Result result = new Result (d, query.query_string);
-            ResultSet results = new ResultSet ();
-            results.add (result, Match.Score.AVERAGE);
-            query.check_cancellable ();
-            return results;
-          }
-        }
-        catch (Error err)
-        {
-          if (!query.is_cancelled ()) warning ("%s", err.message);
-        }
+      Pid pid;
+      int read_fd, write_fd;
+      string[] argv = {"bc", "-l"};
+      string? solution = null;
+
+      try
+      {
+        Process.spawn_async_with_pipes (null, argv, null,
+                                        SpawnFlags.SEARCH_PATH,
+                                        null, out pid, out write_fd, out read_fd);
+        UnixInputStream read_stream = new UnixInputStream (read_fd, true);
+        DataInputStream bc_output = new DataInputStream (read_stream);
+
+        UnixOutputStream write_stream = new UnixOutputStream (write_fd, true);
+        DataOutputStream bc_input = new DataOutputStream (write_stream);
+
+        bc_input.put_string (input + "\n", cancellable);
+        yield bc_input.close_async (Priority.DEFAULT, cancellable);
+        solution = yield bc_output.read_line_async (Priority.DEFAULT_IDLE, cancellable);
+      }
+      catch (Error err)
+      {
+        if (cancellable == null || !cancellable.is_cancelled ()) warning ("%s", err.message);
       }
 
-      query.check_cancellable ();
-      return null;
+      return solution != null ? double.parse (solution) : double.NAN;
     }
   }
 }
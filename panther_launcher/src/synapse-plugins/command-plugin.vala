@@ -69,6 +69,324 @@ namespace Synapse
       }
     }
     
+    /**
+     * Names of the executables in $PATH, kept up to date by monitoring the
+     * directories, so commands can be checked and completed without touching
+     * the file system.
+     */
+    private class ExecutableIndex : Object
+    {
+      // package managers change many files at once
+      private const uint RESCAN_DELAY = 2000;
+      private const string ATTRIBUTES = FileAttribute.STANDARD_NAME + "," +
+                                        FileAttribute.STANDARD_TYPE + "," +
+                                        FileAttribute.ACCESS_CAN_EXECUTE;
+
+      private Utils.AsyncOnce<bool> init_once;
+      private Gee.Set<string> names;
+      // the same names, sorted for prefix lookups
+      private Gee.List<string> sorted_names;
+      private Gee.List<FileMonitor> directory_monitors;
+      private uint rescan_timer_id = 0;
+
+      construct
+      {
+        init_once = new Utils.AsyncOnce<bool> ();
+        names = new Gee.HashSet<string> ();
+        sorted_names = new Gee.ArrayList<string> ();
+        directory_monitors = new Gee.ArrayList<FileMonitor> ();
+      }
+
+      public async void initialize ()
+      {
+        if (init_once.is_initialized ()) return;
+        var is_locked = yield init_once.enter ();
+        if (!is_locked) return;
+
+        yield scan ();
+        monitor_directories ();
+
+        init_once.leave (true);
+      }
+
+      /**
+       * Until the first scan finished this looks the name up in $PATH, so
+       * queries don't have to wait for the index.
+       */
+      public bool contains (string name)
+      {
+        if (!init_once.is_initialized ())
+        {
+          return Environment.find_program_in_path (name) != null;
+        }
+
+        return name in names;
+      }
+
+      /**
+       * Returns up to max_results names starting with the prefix, in
+       * alphabetical order. Nothing is completed until the first scan
+       * finished.
+       */
+      public Gee.List<string> complete (string prefix, int max_results)
+      {
+        // binary search for the first name not sorted before the prefix
+        int low = 0;
+        int high = sorted_names.size;
+        while (low < high)
+        {
+          int mid = (low + high) / 2;
+          if (strcmp (sorted_names[mid], prefix) < 0) low = mid + 1;
+          else high = mid;
+        }
+
+        var result = new Gee.ArrayList<string> ();
+        for (int i = low; i < sorted_names.size && result.size < max_results; i++)
+        {
+          if (!sorted_names[i].has_prefix (prefix)) break;
+          result.add (sorted_names[i]);
+        }
+
+        return result;
+      }
+
+      private static string[] get_path_directories ()
+      {
+        string[] dirs = {};
+        var seen = new Gee.HashSet<string> ();
+        foreach (unowned string dir in (Environment.get_variable ("PATH") ?? "").split (":"))
+        {
+          if (dir != "" && seen.add (dir)) dirs += dir;
+        }
+
+        return dirs;
+      }
+
+      private async void scan ()
+      {
+        var found = new Gee.HashSet<string> ();
+        foreach (unowned string dir in get_path_directories ())
+        {
+          yield scan_directory (File.new_for_path (dir), found);
+        }
+
+        var sorted = new Gee.ArrayList<string> ();
+        sorted.add_all (found);
+        sorted.sort ((a, b) => strcmp (a, b));
+
+        names = found;
+        sorted_names = sorted;
+      }
+
+      private async void scan_directory (File directory, Gee.Set<string> found)
+      {
+        try
+        {
+          var enumerator = yield directory.enumerate_children_async (
+            ATTRIBUTES, 0, Priority.LOW);
+          while (true)
+          {
+            var files = yield enumerator.next_files_async (64, Priority.LOW);
+            if (files == null) break;
+
+            foreach (var info in files)
+            {
+              if (info.get_file_type () == FileType.DIRECTORY) continue;
+              if (!info.get_attribute_boolean (FileAttribute.ACCESS_CAN_EXECUTE)) continue;
+
+              found.add (info.get_name ());
+            }
+          }
+        }
+        catch (Error err)
+        {
+          // directories in $PATH don't need to exist
+        }
+      }
+
+      private void monitor_directories ()
+      {
+        foreach (unowned string dir in get_path_directories ())
+        {
+          try
+          {
+            FileMonitor monitor = File.new_for_path (dir).monitor_directory (0, null);
+            monitor.changed.connect (this.schedule_rescan);
+            directory_monitors.add (monitor);
+          }
+          catch (Error err)
+          {
+            warning ("Unable to monitor directory: %s", err.message);
+          }
+        }
+      }
+
+      private void schedule_rescan ()
+      {
+        if (rescan_timer_id != 0) Source.remove (rescan_timer_id);
+
+        rescan_timer_id = Timeout.add (RESCAN_DELAY, () =>
+        {
+          rescan_timer_id = 0;
+          scan.begin ();
+          return false;
+        });
+      }
+    }
+
+    /**
+     * Commands executed through the plugin, ranked by how often and how
+     * recently they were used and saved across sessions.
+     */
+    private class CommandHistory : Object
+    {
+      private const string VARIANT_TYPE = "a(sux)";
+      private const int MAX_COMMANDS = 200;
+
+      private class Entry
+      {
+        public uint count;
+        public int64 last_used;
+      }
+
+      private Gee.Map<string, Entry> entries;
+
+      construct
+      {
+        entries = new Gee.HashMap<string, Entry> ();
+        load ();
+      }
+
+      public bool contains (string command)
+      {
+        return entries.has_key (command);
+      }
+
+      public Gee.Set<string> get_commands ()
+      {
+        return entries.keys;
+      }
+
+      /**
+       * Returns the uses of the command, weighted by how long ago it was
+       * last used.
+       */
+      public double get_frecency (string command)
+      {
+        var entry = entries[command];
+        if (entry == null) return 0.0;
+
+        int64 days = (get_real_time () - entry.last_used) / TimeSpan.DAY;
+        double weight;
+        if (days < 4) weight = 1.0;
+        else if (days < 14) weight = 0.7;
+        else if (days < 31) weight = 0.5;
+        else if (days < 90) weight = 0.3;
+        else weight = 0.1;
+
+        return entry.count * weight;
+      }
+
+      /**
+       * Maps the frecency of the command to a relevancy bonus between 0
+       * and Match.Score.INCREMENT_MEDIUM.
+       */
+      public int get_relevancy_bonus (string command)
+      {
+        double frecency = get_frecency (command);
+        return (int) (Match.Score.INCREMENT_MEDIUM * (frecency / (frecency + 5.0)));
+      }
+
+      public void add (string command)
+      {
+        var entry = entries[command];
+        if (entry == null)
+        {
+          entry = new Entry ();
+          entries[command] = entry;
+        }
+        entry.count++;
+        entry.last_used = get_real_time ();
+
+        if (entries.size > MAX_COMMANDS) remove_least_used ();
+
+        save.begin ();
+      }
+
+      private void remove_least_used ()
+      {
+        string? least_used = null;
+        double least_frecency = double.MAX;
+        foreach (var command in entries.keys)
+        {
+          double frecency = get_frecency (command);
+          if (frecency < least_frecency)
+          {
+            least_used = command;
+            least_frecency = frecency;
+          }
+        }
+
+        if (least_used != null) entries.unset (least_used);
+      }
+
+      private static string get_file_name ()
+      {
+        return Path.build_filename (Environment.get_user_data_dir (), "synapse",
+                                    "command-history");
+      }
+
+      private void load ()
+      {
+        Variant history;
+        try
+        {
+          var mapped = new MappedFile (get_file_name (), false);
+          history = new Variant.from_bytes (new VariantType (VARIANT_TYPE),
+                                            mapped.get_bytes (), false);
+        }
+        catch (Error err)
+        {
+          return;
+        }
+
+        var iter = history.iterator ();
+        Variant? record;
+        while ((record = iter.next_value ()) != null)
+        {
+          var entry = new Entry ();
+          entry.count = record.get_child_value (1).get_uint32 ();
+          entry.last_used = record.get_child_value (2).get_int64 ();
+          entries[record.get_child_value (0).get_string ()] = entry;
+        }
+      }
+
+      private async void save ()
+      {
+        var builder = new VariantBuilder (new VariantType (VARIANT_TYPE));
+        foreach (var e in entries.entries)
+        {
+          builder.add ("(sux)", e.key, (uint32) e.value.count, e.value.last_used);
+        }
+        var history = builder.end ();
+
+        try
+        {
+          var file = File.new_for_path (get_file_name ());
+          DirUtils.create_with_parents (file.get_parent ().get_path (), 0700);
+          string? etag;
+          yield file.replace_contents_bytes_async (history.get_data_as_bytes (),
+                                                   null, false,
+                                                   FileCreateFlags.REPLACE_DESTINATION,
+                                                   null, out etag);
+        }
+        catch (Error err)
+        {
+          warning ("Unable to save command history: %s", err.message);
+        }
+      }
+    }
+
     static void register_plugin ()
     {
       DataSink.PluginRegistry.get_default ().register_plugin (
@@ -85,13 +403,18 @@ namespace Synapse
       register_plugin ();
     }
 
-    private Gee.Set<string> past_commands;
+    // executables completing the typed name, below an exact command
+    private const int MAX_COMPLETIONS = 5;
+
+    private CommandHistory past_commands;
+    private ExecutableIndex executables;
     private Regex split_regex;
 
     construct
     {
-      // TODO: load from configuration
-      past_commands = new Gee.HashSet<string> ();
+      past_commands = new CommandHistory ();
+      executables = new ExecutableIndex ();
+      executables.initialize.begin ();
       try
       {
         split_regex = new Regex ("\\s+", RegexCompileFlags.OPTIMIZE);
@@ -123,6 +446,7 @@ namespace Synapse
         if (dfi.comment != "") co.description = dfi.comment;
         if (dfi.icon_name != null && dfi.icon_name != "") co.icon_name = dfi.icon_name;
       }
+      co.executed.connect (this.command_executed);
 
       return co;
     }
@@ -135,6 +459,14 @@ namespace Synapse
       past_commands.add (co.command);
     }
 
+    private bool is_executable (string program)
+    {
+      // paths can't be in the index
+      if ("/" in program) return Environment.find_program_in_path (program) != null;
+
+      return executables.contains (program);
+    }
+
     public async ResultSet? search (Query q) throws SearchError
     {
       // we only search for applications
@@ -152,32 +484,46 @@ namespace Synapse
         stripped = stripped.replace ("~", Environment.get_home_dir ());
       }
 
-      if (!(stripped in past_commands))
+      if (!past_commands.contains (stripped))
       {
-        foreach (var command in past_commands)
+        foreach (var command in past_commands.get_commands ())
         {
           if (command.has_prefix (stripped))
           {
-            result.add (create_co (command), Match.Score.AVERAGE);
+            CommandObject? co = create_co (command);
+            if (co == null) continue;
+            result.add (co, Match.Score.AVERAGE + past_commands.get_relevancy_bonus (command));
           }
         }
 
         string[] args = split_regex.split (stripped);
-        string? valid_cmd = Environment.find_program_in_path (args[0]);
+        if (args.length == 1 && !("/" in stripped) && stripped.length > 1)
+        {
+          foreach (var name in executables.complete (stripped, MAX_COMPLETIONS))
+          {
+            if (name == stripped || name == "rm" || past_commands.contains (name)) continue;
+            CommandObject? co = create_co (name);
+            if (co == null) continue;
+            result.add (co, Match.Score.POOR - Match.Score.INCREMENT_MINOR);
+          }
+        }
 
-        if (valid_cmd != null)
+        if (is_executable (args[0]))
         {
           // don't allow dangerous commands
           if (args[0] == "rm") return null;
           CommandObject? co = create_co (stripped);
           if (co == null) return null;
           result.add (co, Match.Score.POOR);
-          co.executed.connect (this.command_executed);
         }
       }
       else
       {
-        result.add (create_co (stripped), Match.Score.VERY_GOOD);
+        CommandObject? co = create_co (stripped);
+        if (co != null)
+        {
+          result.add (co, Match.Score.VERY_GOOD + past_commands.get_relevancy_bonus (stripped));
+        }
       }
       
       q.check_cancellable ();
@@ -48,20 +48,25 @@ namespace Synapse
       public AppInfo? app_info { get; set; default = null; }
       public bool needs_terminal { get; set; default = false; }
 
+      private string desktop_id;
       private string action_name;
 
-      public ActionMatch (string desktop_id, string action_name)
+      public ActionMatch (string desktop_id, string action_name,
+                          string title, string icon_name)
       {
-        var desktop_app_info = new DesktopAppInfo (desktop_id);
-        this.title = desktop_app_info.get_action_name (action_name);
-        this.icon_name = desktop_app_info.get_icon ().to_string ();
+        this.title = title;
+        this.icon_name = icon_name;
         this.description = "";
-        this.app_info = desktop_app_info;
+        this.desktop_id = desktop_id;
         this.action_name = action_name;
       }   
 
       public void execute (Match? match)
       {
+        // only parse the desktop file once the action is really launched
+        if (app_info == null) app_info = new DesktopAppInfo (desktop_id);
+        if (app_info == null) return;
+
         ((DesktopAppInfo) app_info).launch_action (action_name, new AppLaunchContext ());
       }       
     }
@@ -83,6 +88,15 @@ namespace Synapse
 
       // for additional matching
       public string generic_name { get; construct set; default = ""; }
+      public string generic_name_folded { get; private set; default = ""; }
+      public string comment_folded { get; private set; default = ""; }
+      public string[] keywords_folded = {};
+
+      // desktop actions, parsed by the DesktopFileService
+      public string[] action_ids;
+      public string[] action_names;
+      public string[] action_names_folded;
+      private ActionMatch[] action_matches;
       
       private string? title_folded = null;
       public unowned string get_title_folded ()
@@ -114,6 +128,49 @@ namespace Synapse
         this.title_unaccented = Utils.remove_accents (this.title_folded);
         this.desktop_id = "application://" + info.desktop_id;
         this.generic_name = info.generic_name;
+        this.generic_name_folded = info.generic_name.casefold ();
+        this.comment_folded = info.comment.casefold ();
+        if (info.keywords != null)
+        {
+          foreach (unowned string keyword in info.keywords)
+            keywords_folded += keyword.casefold ();
+        }
+        this.action_ids = info.action_ids;
+        this.action_names = info.action_names;
+        this.action_names_folded = info.action_names_folded;
+        this.action_matches = new ActionMatch[info.action_ids.length];
+      }
+
+      public ActionMatch get_action_match (int index)
+      {
+        if (action_matches[index] == null)
+        {
+          string id = desktop_id.replace ("application://", "");
+          action_matches[index] = new ActionMatch (id, action_ids[index],
+                                                   action_names[index], icon_name);
+        }
+        return action_matches[index];
+      }
+
+      public void add_to_index (TextIndex index, int id)
+      {
+        string?[] titles = { get_title_folded (), title_unaccented };
+        foreach (unowned string action_name in action_names_folded)
+          titles += action_name;
+        string?[] texts = { generic_name_folded, comment_folded, exec.casefold () };
+        foreach (unowned string keyword in keywords_folded)
+          texts += keyword;
+
+        index.add_document (id, titles, texts);
+      }
+
+      public bool matches_keyword (string query)
+      {
+        foreach (unowned string keyword in keywords_folded)
+        {
+          if (keyword.contains (query)) return true;
+        }
+        return false;
       }
     }
 
@@ -134,6 +191,7 @@ namespace Synapse
     }
     
     private Gee.List<DesktopFileMatch> desktop_files;
+    private TextIndex? index = null;
 
     construct
     {
@@ -147,6 +205,7 @@ namespace Synapse
       dfs.reload_done.connect (() => {
         mimetype_map.clear ();
         desktop_files.clear ();
+        index = null;
         load_all_desktop_files.begin ();
       });
 
@@ -169,6 +228,12 @@ namespace Synapse
         desktop_files.add (new DesktopFileMatch.for_info (dfi));
       }
 
+      index = new TextIndex (desktop_files.size);
+      for (int i = 0; i < desktop_files.size; i++)
+      {
+        desktop_files[i].add_to_index (index, i);
+      }
+
       loading_in_progress = false;
       load_complete ();
     }
@@ -187,74 +252,34 @@ namespace Synapse
     private void full_search (Query q, ResultSet results,
                               MatcherFlags flags = 0)
     {
-      // try to match against global matchers and if those fail, try also exec
-      var matchers = Query.get_matchers_for_query (q.query_string_folded,
-                                                   flags);
+      // try to match against the title and if that fails, try also exec
+      var matcher = new FuzzyMatcher (q.query_string_folded, flags);
+      if (index == null) return;
 
-      foreach (var dfm in desktop_files)
+      // only look at the desktop files which could match at all
+      bool fuzzy = !(MatcherFlags.NO_FUZZY in flags && MatcherFlags.NO_PARTIAL in flags);
+      foreach (int id in index.find_candidates (q.query_string_folded, fuzzy))
       {
+        var dfm = desktop_files[id];
         unowned string folded_title = dfm.get_title_folded ();
         unowned string unaccented_title = dfm.title_unaccented;
-        unowned string comment = dfm.description;
-        unowned string generic_name = dfm.generic_name;
 
         bool matched = false;
-        // FIXME: we need to do much smarter relevancy computation in fuzzy re
-        // "sysmon" matching "System Monitor" is very good as opposed to
-        // "seto" matching "System Monitor"
-        foreach (var matcher in matchers)
+        int score;
+        if (matcher.match (folded_title, out score))
         {
-          MatchInfo info;
-          if (matcher.key.match (folded_title, 0, out info))
-          {
-            results.add (dfm, compute_relevancy (dfm, matcher.value));
-            matched = true;
-            break;
-          }
-          else if (unaccented_title != null && matcher.key.match (unaccented_title))
-          {
-            results.add (dfm, compute_relevancy (dfm, matcher.value - Match.Score.INCREMENT_SMALL));
-            matched = true;
-            break;
-          } 
-          else if (info.is_partial_match ())
-          {
-            results.add (dfm, compute_relevancy (dfm, Match.Score.INCREMENT_SMALL));
-            matched = true;
-            break;
-          }
+          results.add (dfm, compute_relevancy (dfm, score));
+          matched = true;
         }
-
-        string id = dfm.desktop_id.replace ("application://", "");
-        var desktop_app_info = new DesktopAppInfo (id);
-        string[] actions = desktop_app_info.list_actions ();
-        foreach (string action in actions) {
-          string title = desktop_app_info.get_action_name (action).down ();
-          foreach (var matcher in matchers)
-          {
-            MatchInfo action_info;
-            if (matcher.key.match (title, 0, out action_info)
-                || title.contains (q.query_string_folded)
-                || title.has_prefix (q.query_string))
-            {
-              var am = new ActionMatch (id, action);
-              results.add (am, compute_relevancy (dfm, Match.Score.INCREMENT_SMALL));
-              matched = true;
-              break;
-            }
-
-            else if (action_info.is_partial_match ())
-            {
-              var am = new ActionMatch (id, action);
-              results.add (am, compute_relevancy (dfm, Match.Score.INCREMENT_SMALL));
-              matched = true;  
-              break;        
-            }
-          }
+        else if (unaccented_title != null && matcher.match (unaccented_title, out score))
+        {
+          results.add (dfm, compute_relevancy (dfm, score - Match.Score.INCREMENT_SMALL));
+          matched = true;
         }
 
-        if (!matched && (comment.down ().contains (q.query_string_folded) 
-            || generic_name.down ().contains (q.query_string_folded)))
+        if (!matched && (dfm.comment_folded.contains (q.query_string_folded)
+            || dfm.generic_name_folded.contains (q.query_string_folded)
+            || dfm.matches_keyword (q.query_string_folded)))
         {
             results.add (dfm, compute_relevancy (dfm, Match.Score.AVERAGE - Match.Score.INCREMENT_MEDIUM));
             matched = true;
@@ -264,6 +289,19 @@ namespace Synapse
           results.add (dfm, compute_relevancy (dfm, dfm.exec == q.query_string ?
             Match.Score.VERY_GOOD : Match.Score.AVERAGE - Match.Score.INCREMENT_SMALL));
         }
+
+        // desktop actions were indexed as titles of their application
+        for (int i = 0; i < dfm.action_names_folded.length; i++)
+        {
+          unowned string title = dfm.action_names_folded[i];
+          if (matcher.match (title, out score)
+              || title.contains (q.query_string_folded)
+              || title.has_prefix (q.query_string))
+          {
+            results.add (dfm.get_action_match (i),
+                         compute_relevancy (dfm, Match.Score.INCREMENT_SMALL));
+          }
+        }
       }
     }
 
@@ -300,7 +338,7 @@ namespace Synapse
       q.check_cancellable ();
 
       // FIXME: spawn new thread and do the search there?
-      var result = new ResultSet ();
+      var result = new ResultSet.with_limit ((int) q.max_results);
 
       // FIXME: make sure this is one unichar, not just byte
       if (q.query_string.length == 1)
@@ -409,17 +447,13 @@ namespace Synapse
       }
       else
       {
-        var matchers = Query.get_matchers_for_query (query.query_string, 0,
-          RegexCompileFlags.OPTIMIZE | RegexCompileFlags.CASELESS);
+        var matcher = new FuzzyMatcher (query.query_string);
         foreach (var action in ow_list)
         {
-          foreach (var matcher in matchers)
+          int score;
+          if (matcher.match (action.title, out score))
           {
-            if (matcher.key.match (action.title))
-            {
-              rs.add (action, matcher.value);
-              break;
-            }
+            rs.add (action, score);
           }
         }
       }
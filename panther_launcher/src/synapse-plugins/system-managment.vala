@@ -500,19 +500,15 @@ namespace Synapse
 
       var result = new ResultSet ();
 
-      var matchers = Query.get_matchers_for_query (q.query_string, 0,
-        RegexCompileFlags.OPTIMIZE | RegexCompileFlags.CASELESS);
+      var matcher = new FuzzyMatcher (q.query_string);
 
       foreach (var action in actions)
       {
         if (!action.action_allowed ()) continue;
-        foreach (var matcher in matchers)
+        int score;
+        if (matcher.match (action.title, out score))
         {
-          if (matcher.key.match (action.title))
-          {
-            result.add (action, matcher.value - Match.Score.INCREMENT_SMALL);
-            break;
-          }
+          result.add (action, score - Match.Score.INCREMENT_SMALL);
         }
       }
 
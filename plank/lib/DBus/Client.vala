@@ -65,6 +65,7 @@ namespace Plank
 		uint dbus_name_owner_changed_signal_id = 0;
 		
 		DBusItemsIface? items_proxy = null;
+		DBusStatsIface? stats_proxy = null;
 		int items_count = int.MIN;
 		string[]? persistent_apps_list = null;
 		string[]? transient_apps_list = null;
@@ -168,6 +169,14 @@ namespace Plank
 				critical ("Failed to create items proxy for '%s' (%s)", sender_name, object_path);
 			}
 			
+			try {
+				if (items_proxy != null)
+					stats_proxy = connection.get_proxy_sync<Plank.DBusStatsIface> (sender_name, object_path, DBusProxyFlags.NONE);
+			} catch (Error e) {
+				stats_proxy = null;
+				warning ("Failed to create stats proxy for '%s' (%s)", sender_name, object_path);
+			}
+			
 			proxy_changed ();
 		}
 		
@@ -181,6 +190,7 @@ namespace Plank
 			
 			items_proxy.changed.disconnect (invalidate_items_cache);
 			items_proxy = null;
+			stats_proxy = null;
 		}
 		
 		
@@ -334,5 +344,68 @@ namespace Plank
 			
 			return false;
 		}
+		
+		/**
+		 * Returns the counters of the surface-cache shared by all items of the dock
+		 *
+		 * @return a dictionary of the counters, or null on failure
+		 */
+		public HashTable<string, Variant>? get_surface_cache_stats ()
+		{
+			if (stats_proxy == null) {
+				warning ("No proxy connected");
+				return null;
+			}
+			
+			try {
+				return stats_proxy.get_surface_cache_stats ();
+			} catch (Error e) {
+				warning (e.message);
+			}
+			
+			return null;
+		}
+		
+		/**
+		 * Returns the timings of the recent frames of the dock
+		 *
+		 * @return a dictionary of the timings and counters, or null on failure
+		 */
+		public HashTable<string, Variant>? get_frame_stats ()
+		{
+			if (stats_proxy == null) {
+				warning ("No proxy connected");
+				return null;
+			}
+			
+			try {
+				return stats_proxy.get_frame_stats ();
+			} catch (Error e) {
+				warning (e.message);
+			}
+			
+			return null;
+		}
+		
+		/**
+		 * Returns the counters of the worker threads of the dock
+		 *
+		 * @return a dictionary of the counters, or null on failure
+		 */
+		public HashTable<string, Variant>? get_worker_stats ()
+		{
+			if (stats_proxy == null) {
+				warning ("No proxy connected");
+				return null;
+			}
+			
+			try {
+				return stats_proxy.get_worker_stats ();
+			} catch (Error e) {
+				warning (e.message);
+			}
+			
+			return null;
+		}
 	}
 }
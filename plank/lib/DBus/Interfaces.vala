@@ -83,4 +83,35 @@ namespace Plank
 		 */
 		public abstract bool get_hover_position (string uri, out int x, out int y, out Gtk.PositionType dock_position) throws GLib.DBusError, GLib.IOError;
 	}
+	
+	/**
+	 * Provide runtime statistics of the dock
+	 */
+	[DBus (name = "net.launchpad.plank.Stats")]
+	interface DBusStatsIface : GLib.Object
+	{
+		/**
+		 * Returns the counters of the surface-cache shared by all items,
+		 * like "hits", "misses", "evictions", "bytes" and "budget"
+		 *
+		 * @return a dictionary of the counters
+		 */
+		public abstract HashTable<string, Variant> get_surface_cache_stats () throws GLib.DBusError, GLib.IOError;
+		
+		/**
+		 * Returns the timings of the recent frames of the dock in microseconds,
+		 * like "initialize-time", "draw-time" and "frame-interval"
+		 *
+		 * @return a dictionary of the timings and counters
+		 */
+		public abstract HashTable<string, Variant> get_frame_stats () throws GLib.DBusError, GLib.IOError;
+		
+		/**
+		 * Returns the counters of the worker threads, like "queued-high",
+		 * "completed", "stolen" and "average-wait-time" in microseconds
+		 *
+		 * @return a dictionary of the counters
+		 */
+		public abstract HashTable<string, Variant> get_worker_stats () throws GLib.DBusError, GLib.IOError;
+	}
 }
@@ -162,6 +162,34 @@ namespace Plank
 		}
 	}
 	
+	/**
+	 * Provide runtime statistics of the dock
+	 */
+	class DBusStats : GLib.Object, Plank.DBusStatsIface
+	{
+		DockController controller;
+		
+		public DBusStats (DockController _controller)
+		{
+			controller = _controller;
+		}
+		
+		public HashTable<string, Variant> get_surface_cache_stats ()
+		{
+			return SurfaceCacheBudget.get_default ().get_stats ();
+		}
+		
+		public HashTable<string, Variant> get_frame_stats ()
+		{
+			return controller.renderer.get_frame_stats ();
+		}
+		
+		public HashTable<string, Variant> get_worker_stats ()
+		{
+			return Worker.get_default ().get_stats ();
+		}
+	}
+	
 	/**
 	 * Handles all the exported DBus functions of the dock
 	 */
@@ -173,6 +201,7 @@ namespace Plank
 		string? dock_object_path;
 		
 		uint dbus_items_signal_id = 0U;
+		uint dbus_stats_signal_id = 0U;
 		uint dbus_client_ping_signal_id = 0U;
 		
 		public DBusManager (DockController controller)
@@ -211,6 +240,13 @@ namespace Plank
 				warning ("Could not register service (%s)", e.message);
 			}
 			
+			try {
+				var dbus_stats = new DBusStats (controller);
+				dbus_stats_signal_id = connection.register_object<Plank.DBusStatsIface> (object_path, dbus_stats);
+			} catch (IOError e) {
+				warning ("Could not register service (%s)", e.message);
+			}
+			
 			dock_object_path = (owned) object_path;
 			
 			try {
@@ -226,6 +262,8 @@ namespace Plank
 			if (connection != null) {
 				if (dbus_items_signal_id > 0U)
 					connection.unregister_object (dbus_items_signal_id);
+				if (dbus_stats_signal_id > 0U)
+					connection.unregister_object (dbus_stats_signal_id);
 				if (dbus_client_ping_signal_id > 0U)
 					connection.signal_unsubscribe (dbus_client_ping_signal_id);
 			}
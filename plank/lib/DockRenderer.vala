@@ -24,6 +24,68 @@ namespace Plank
 	 */
 	public class DockRenderer : Renderer
 	{
+		/**
+		 * The last drawn state of an item, used to find out which parts
+		 * of the dock need to be redrawn.
+		 */
+		class ItemDrawState
+		{
+			public uint serial;
+			public bool needs_redraw = true;
+			public Cairo.RectangleInt extent;
+			
+			bool visible;
+			Gdk.Rectangle draw_region;
+			Gdk.Rectangle hover_region;
+			Gdk.Rectangle background_region;
+			double opacity;
+			double darken;
+			double lighten;
+			double active_opacity;
+			bool show_indicator;
+			IndicatorState indicator;
+			ItemState state;
+			
+			/**
+			 * Stores the given values.
+			 *
+			 * @return whether the item looks different than before
+			 */
+			public bool update (bool _visible, DockItemDrawValue draw_value, IndicatorState _indicator, ItemState _state, double _active_opacity)
+			{
+				var changed = needs_redraw
+					|| visible != _visible
+					|| !rectangle_equal (draw_region, draw_value.draw_region)
+					|| !rectangle_equal (hover_region, draw_value.hover_region)
+					|| !rectangle_equal (background_region, draw_value.background_region)
+					|| opacity != draw_value.opacity
+					|| darken != draw_value.darken
+					|| lighten != draw_value.lighten
+					|| active_opacity != _active_opacity
+					|| show_indicator != draw_value.show_indicator
+					|| indicator != _indicator
+					|| state != _state;
+				
+				if (!changed)
+					return false;
+				
+				needs_redraw = false;
+				visible = _visible;
+				draw_region = draw_value.draw_region;
+				hover_region = draw_value.hover_region;
+				background_region = draw_value.background_region;
+				opacity = draw_value.opacity;
+				darken = draw_value.darken;
+				lighten = draw_value.lighten;
+				active_opacity = _active_opacity;
+				show_indicator = draw_value.show_indicator;
+				indicator = _indicator;
+				state = _state;
+				
+				return true;
+			}
+		}
+		
 		public DockController controller { private get; construct; }
 		
 		public DockTheme theme { get; private set; }
@@ -72,6 +134,7 @@ namespace Plank
 		int window_scale_factor = 1;
 		bool is_first_frame = true;
 		bool zoom_changed = false;
+		bool show_frame_stats = false;
 		
 		ulong gtk_theme_name_changed_handler_id = 0UL;
 		
@@ -79,6 +142,14 @@ namespace Plank
 		
 		Gee.ArrayList<unowned DockItem> current_items;
 		Gee.HashSet<DockItem> transient_items;
+		
+		Gee.HashMap<DockItem, ItemDrawState> item_draw_states;
+		uint item_draw_serial = 0U;
+		// The damage accumulated since the last draw, null if a full redraw is required
+		Cairo.Region? damage = null;
+		Gdk.Rectangle last_window_rect;
+		Gdk.Rectangle last_background_rect;
+		double last_hide_progress = 0.0;
 #if BENCHMARK
 		Gee.ArrayList<string> benchmark;
 #endif
@@ -98,6 +169,8 @@ namespace Plank
 		{
 			transient_items = new Gee.HashSet<DockItem> ();
 			current_items = new Gee.ArrayList<unowned DockItem> ();
+			item_draw_states = new Gee.HashMap<DockItem, ItemDrawState> ();
+			show_frame_stats = (Environment.get_variable ("PLANK_SHOW_FRAME_STATS") != null);
 #if BENCHMARK
 			benchmark = new Gee.ArrayList<string> ();
 #endif
@@ -127,6 +200,9 @@ namespace Plank
 			controller.hide_manager.notify["Hidden"].disconnect (hidden_changed);
 			controller.hide_manager.notify["Hovered"].disconnect (hovered_changed);
 			controller.window.notify["HoveredItem"].disconnect (animated_draw);
+			
+			foreach (var item in item_draw_states.keys)
+				item.needs_redraw.disconnect (item_needs_redraw);
 		}
 		
 		void prefs_changed (Object prefs, ParamSpec prop)
@@ -331,6 +407,117 @@ namespace Plank
 				(DrawValuesFunc) post_process_draw_values);
 			
 			background_rect = position_manager.get_background_region ();
+			
+			update_damage (frame_time);
+		}
+		
+		/**
+		 * {@inheritDoc}
+		 */
+		protected override Cairo.Region? get_damage_region ()
+		{
+			// the overlay changes with every frame
+			if (show_frame_stats)
+				return null;
+			
+			return (damage != null ? damage.copy () : null);
+		}
+		
+		/**
+		 * Compares the state of all items with the one of the previous frame
+		 * and accumulates the areas of the changed items.
+		 * A full redraw is required while the dock is moving or fading,
+		 * or if its background or size changed.
+		 */
+		void update_damage (int64 frame_time)
+		{
+			unowned PositionManager position_manager = controller.position_manager;
+			unowned DockItem dragged_item = controller.drag_manager.DragItem;
+			var win_rect = position_manager.get_dock_window_region ();
+			
+			var full_damage = (is_first_frame
+				|| main_buffer == null || item_buffer == null || shadow_buffer == null
+				|| hide_progress > 0.0 || last_hide_progress > 0.0
+				|| win_rect.width != last_window_rect.width || win_rect.height != last_window_rect.height
+				|| !rectangle_equal (background_rect, last_background_rect));
+			
+			last_hide_progress = hide_progress;
+			last_window_rect = win_rect;
+			last_background_rect = background_rect;
+			
+			var frame_damage = new Cairo.Region ();
+			item_draw_serial++;
+			
+			foreach (unowned DockItem item in current_items) {
+				var state = item_draw_states.get (item);
+				if (state == null) {
+					state = new ItemDrawState ();
+					item_draw_states.set (item, state);
+					item.needs_redraw.connect (item_needs_redraw);
+				}
+				state.serial = item_draw_serial;
+				
+				var draw_value = position_manager.get_draw_value_for_item (item);
+				var visible = (item.IsVisible && dragged_item != item);
+				if (!state.update (visible, draw_value, item.Indicator, item.State, get_active_glow_opacity (item, frame_time)))
+					continue;
+				
+				frame_damage.union_rectangle (state.extent);
+				state.extent = get_item_damage_extent (draw_value, win_rect);
+				frame_damage.union_rectangle (state.extent);
+			}
+			
+			var states_it = item_draw_states.map_iterator ();
+			while (states_it.next ()) {
+				var state = states_it.get_value ();
+				if (state.serial == item_draw_serial)
+					continue;
+				
+				frame_damage.union_rectangle (state.extent);
+				states_it.get_key ().needs_redraw.disconnect (item_needs_redraw);
+				states_it.unset ();
+			}
+			
+			if (full_damage)
+				damage = null;
+			else if (damage != null)
+				damage.union (frame_damage);
+		}
+		
+		/**
+		 * The area an item might draw to, this covers the full depth of the
+		 * dock to include shadows, glows and indicators.
+		 */
+		Cairo.RectangleInt get_item_damage_extent (DockItemDrawValue draw_value, Gdk.Rectangle win_rect)
+		{
+			unowned PositionManager position_manager = controller.position_manager;
+			var margin = position_manager.IconShadowSize + position_manager.IndicatorSize / 2 + position_manager.IconSize / 16 + 2;
+			var draw_region = draw_value.draw_region;
+			var hover_region = draw_value.hover_region;
+			var background_region = draw_value.background_region;
+			
+			if (position_manager.is_horizontal_dock ()) {
+				var start = int.min (draw_region.x, int.min (hover_region.x, background_region.x)) - margin;
+				var end = int.max (draw_region.x + draw_region.width,
+					int.max (hover_region.x + hover_region.width, background_region.x + background_region.width)) + margin;
+				return { start, 0, end - start, win_rect.height };
+			} else {
+				var start = int.min (draw_region.y, int.min (hover_region.y, background_region.y)) - margin;
+				var end = int.max (draw_region.y + draw_region.height,
+					int.max (hover_region.y + hover_region.height, background_region.y + background_region.height)) + margin;
+				return { 0, start, win_rect.width, end - start };
+			}
+		}
+		
+		void item_needs_redraw (DockElement element)
+		{
+			var state = item_draw_states.get ((DockItem) element);
+			if (state == null)
+				return;
+			
+			// The provider already requested a frame before we got notified
+			state.needs_redraw = true;
+			animated_draw ();
 		}
 		
 		/**
@@ -345,12 +532,18 @@ namespace Plank
 			}
 			
 			window_scale_factor = controller.window.get_window ().get_scale_factor ();
+			
+			// only the accumulated damage needs to be redrawn if the buffers are still valid
+			Cairo.Region? frame_damage = null;
+			if (main_buffer != null && item_buffer != null && shadow_buffer != null && opacity == 1.0)
+				frame_damage = damage;
+			damage = new Cairo.Region ();
+			
 			// take the previous frame values into account to decide if we
 			// can bail a full draw to not miss a finishing animation-frame
 			var no_full_draw_needed = (!is_first_frame && hide_progress == 1.0 && opacity == 1.0);
 			
 			unowned PositionManager position_manager = controller.position_manager;
-			unowned DockItem dragged_item = controller.drag_manager.DragItem;
 			var win_rect = position_manager.get_dock_window_region ();
 			
 			if (main_buffer == null) {
@@ -391,61 +584,13 @@ namespace Plank
 			}
 			
 #if BENCHMARK
-			DateTime start, start2, end, end2;
+			DateTime start, end;
 			benchmark.clear ();
 			start = new DateTime.now_local ();
 #endif
 			
-			main_buffer.clear ();
-			item_buffer.clear ();
-			shadow_buffer.clear ();
-			unowned Cairo.Context item_cr = item_buffer.Context;
-			unowned Cairo.Context shadow_cr = shadow_buffer.Context;
-			
-			// calculate drawing offset
-			var x_offset = 0, y_offset = 0;
-			if (opacity == 1.0)
-				position_manager.get_dock_draw_position (out x_offset, out y_offset);
-			
-			// composite dock layers and make sure to draw onto the window's context with one operation
-			main_buffer.clear ();
-			unowned Cairo.Context main_cr = main_buffer.Context;
-			main_cr.set_operator (Cairo.Operator.OVER);
-			
-#if BENCHMARK
-			start2 = new DateTime.now_local ();
-#endif
-			// draw background-layer
-			draw_dock_background (main_cr, background_rect, x_offset, y_offset);
-#if BENCHMARK
-			end2 = new DateTime.now_local ();
-			benchmark.add ("background render time - %f ms".printf (end2.difference (start2) / 1000.0));
-#endif
-			
-			// draw each item onto the dock buffer
-			foreach (unowned DockItem item in current_items) {
-#if BENCHMARK
-				start2 = new DateTime.now_local ();
-#endif
-				// Do not draw the currently dragged item
-				if (item.IsVisible && dragged_item != item) {
-					var draw_value = position_manager.get_draw_value_for_item (item);
-					draw_item (item_cr, item, draw_value, frame_time);
-					draw_item_shadow (shadow_cr, item, draw_value);
-				}
-#if BENCHMARK
-				end2 = new DateTime.now_local ();
-				benchmark.add ("item render time - %f ms".printf (end2.difference (start2) / 1000.0));
-#endif
-			}
-			
-			// draw items-shadow-layer
-			main_cr.set_source_surface (shadow_buffer.Internal, x_offset, y_offset);
-			main_cr.paint ();
-			
-			// draw items-layer
-			main_cr.set_source_surface (item_buffer.Internal, x_offset, y_offset);
-			main_cr.paint ();
+			if (frame_damage == null || !frame_damage.is_empty ())
+				draw_buffers (frame_damage, frame_time);
 			
 			// draw the dock on the window and fade it if need be
 			cr.set_operator (Cairo.Operator.SOURCE);
@@ -468,6 +613,9 @@ namespace Plank
 					draw_urgent_glow (item, cr, frame_time);
 			}
 			
+			if (show_frame_stats)
+				draw_frame_stats (cr);
+			
 #if BENCHMARK
 			end = new DateTime.now_local ();
 			var diff = end.difference (start) / 1000.0;
@@ -483,7 +631,7 @@ namespace Plank
 				Gdk.threads_add_idle_full (GLib.Priority.LOW, () => {
 					unowned HideManager hide_manager = controller.hide_manager;
 					
-					// FIXME HideManager.initialize () -> setup_active_window ();
+					// FIXME HideManager.initialize () -> setup_windows ();
 					// is already taking care of updating the Hidden-state,
 					// but only if there is already an active/open window
 					if (hide_manager.Hidden)
@@ -505,6 +653,138 @@ namespace Plank
 			}
 		}
 		
+		/**
+		 * Renders the dock layers into the main buffer.
+		 *
+		 * @param frame_damage the area to redraw, or null to redraw everything
+		 */
+		void draw_buffers (Cairo.Region? frame_damage, int64 frame_time)
+		{
+			unowned PositionManager position_manager = controller.position_manager;
+			unowned DockItem dragged_item = controller.drag_manager.DragItem;
+			unowned Cairo.Context item_cr = item_buffer.Context;
+			unowned Cairo.Context shadow_cr = shadow_buffer.Context;
+			unowned Cairo.Context main_cr = main_buffer.Context;
+			
+			// calculate drawing offset
+			var x_offset = 0, y_offset = 0;
+			if (opacity == 1.0)
+				position_manager.get_dock_draw_position (out x_offset, out y_offset);
+			
+			// a partial redraw only happens while the dock is not moving,
+			// so the layers are aligned with the window
+			if (frame_damage != null) {
+				clip_and_clear (main_cr, frame_damage);
+				clip_and_clear (item_cr, frame_damage);
+				clip_and_clear (shadow_cr, frame_damage);
+			} else {
+				main_buffer.clear ();
+				item_buffer.clear ();
+				shadow_buffer.clear ();
+			}
+			
+			// composite dock layers and make sure to draw onto the window's context with one operation
+			main_cr.set_operator (Cairo.Operator.OVER);
+			
+#if BENCHMARK
+			DateTime start2, end2;
+			start2 = new DateTime.now_local ();
+#endif
+			// draw background-layer
+			draw_dock_background (main_cr, background_rect, x_offset, y_offset);
+#if BENCHMARK
+			end2 = new DateTime.now_local ();
+			benchmark.add ("background render time - %f ms".printf (end2.difference (start2) / 1000.0));
+#endif
+			
+			// draw each item onto the dock buffer
+			foreach (unowned DockItem item in current_items) {
+#if BENCHMARK
+				start2 = new DateTime.now_local ();
+#endif
+				// Do not draw the currently dragged item, or items which are not affected by the damage
+				if (item.IsVisible && dragged_item != item && !is_item_undamaged (item, frame_damage)) {
+					var draw_value = position_manager.get_draw_value_for_item (item);
+					draw_item (item_cr, item, draw_value, frame_time);
+					draw_item_shadow (shadow_cr, item, draw_value);
+				}
+#if BENCHMARK
+				end2 = new DateTime.now_local ();
+				benchmark.add ("item render time - %f ms".printf (end2.difference (start2) / 1000.0));
+#endif
+			}
+			
+			// draw items-shadow-layer
+			main_cr.set_source_surface (shadow_buffer.Internal, x_offset, y_offset);
+			main_cr.paint ();
+			
+			// draw items-layer
+			main_cr.set_source_surface (item_buffer.Internal, x_offset, y_offset);
+			main_cr.paint ();
+			
+			if (frame_damage != null) {
+				main_cr.restore ();
+				item_cr.restore ();
+				shadow_cr.restore ();
+			}
+		}
+		
+		/**
+		 * Draws the timings of the previous frame in the corner of the window.
+		 */
+		void draw_frame_stats (Cairo.Context cr)
+		{
+			var stats = get_frame_stats ();
+			var text = "init %.2f ms  draw %.2f ms  interval %.1f ms  skipped %i  missed %i".printf (
+				stats["average-initialize-time"].get_double () / 1000.0,
+				stats["average-draw-time"].get_double () / 1000.0,
+				stats["frame-interval"].get_int64 () / 1000.0,
+				(int) stats["skipped-frames"].get_uint64 (),
+				(int) stats["missed-frames"].get_uint64 ());
+			
+			cr.save ();
+			cr.set_operator (Cairo.Operator.OVER);
+			cr.select_font_face ("monospace", Cairo.FontSlant.NORMAL, Cairo.FontWeight.NORMAL);
+			cr.set_font_size (10);
+			
+			Cairo.TextExtents extents;
+			cr.text_extents (text, out extents);
+			cr.rectangle (0, 0, extents.x_advance + 8, extents.height + 8);
+			cr.set_source_rgba (0, 0, 0, 0.7);
+			cr.fill ();
+			
+			cr.move_to (4, 4 - extents.y_bearing);
+			cr.set_source_rgba (1, 1, 1, 1);
+			cr.show_text (text);
+			cr.restore ();
+		}
+		
+		static void clip_and_clear (Cairo.Context cr, Cairo.Region region)
+		{
+			cr.save ();
+			Gdk.cairo_region (cr, region);
+			cr.clip ();
+			
+			cr.save ();
+			cr.set_operator (Cairo.Operator.CLEAR);
+			cr.paint ();
+			cr.restore ();
+		}
+		
+		bool is_item_undamaged (DockItem item, Cairo.Region? frame_damage)
+		{
+			if (frame_damage == null)
+				return false;
+			
+			var state = item_draw_states.get (item);
+			return (state != null && frame_damage.contains_rectangle (state.extent) == Cairo.RegionOverlap.OUT);
+		}
+		
+		static bool rectangle_equal (Gdk.Rectangle a, Gdk.Rectangle b)
+		{
+			return (a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height);
+		}
+		
 		void draw_dock_background (Cairo.Context cr, Gdk.Rectangle background_rect, int x_offset, int y_offset)
 		{
 			unowned PositionManager position_manager = controller.position_manager;
@@ -810,10 +1090,7 @@ namespace Plank
 			}
 			
 			// draw active glow
-			var active_time = int64.max (0LL, frame_time - item.LastActive);
-			var opacity = double.min (1, active_time / (double) (theme.ActiveTime * 1000));
-			if ((item.State & ItemState.ACTIVE) == 0)
-				opacity = 1 - opacity;
+			var opacity = get_active_glow_opacity (item, frame_time);
 			if (opacity > 0) {
 				theme.draw_active_glow (item_buffer, background_rect, draw_value.background_region, item.AverageIconColor, opacity, position);
 			}
@@ -837,6 +1114,15 @@ namespace Plank
 				draw_indicator_state (cr, draw_value.hover_region, item.Indicator, item.State);
 		}
 		
+		double get_active_glow_opacity (DockItem item, int64 frame_time)
+		{
+			var active_time = int64.max (0LL, frame_time - item.LastActive);
+			var opacity = double.min (1, active_time / (double) (theme.ActiveTime * 1000));
+			if ((item.State & ItemState.ACTIVE) == 0)
+				opacity = 1 - opacity;
+			return opacity;
+		}
+		
 		void draw_item_shadow (Cairo.Context cr, DockItem item, DockItemDrawValue draw_value)
 		{
 			unowned PositionManager position_manager = controller.position_manager;
@@ -0,0 +1,255 @@
+//
+//  Copyright (C) 2011-2012 Robert Dyer, Rico Tzschichholz
+//  Copyright (C) 2026 The Plank Developers
+//
+//  This file is part of Plank.
+//
+//  Plank is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Plank is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+namespace Plank
+{
+	/**
+	 * Blurs raw 32bit image data in-place.
+	 *
+	 * Every pass is split into tiles of rows or columns which are processed
+	 * concurrently by the calling thread and the {@link Worker} pool.
+	 * All intermediates are kept as fixed-point integers, the box kernels
+	 * are using SSE2/AVX2 if available.
+	 */
+	internal class BlurEngine : GLib.Object
+	{
+		const int TILE_SIZE = 32;
+		const int PARALLEL_MIN_PIXELS = 128 * 128;
+		const int GAUSSIAN_BOX_COUNT = 3;
+		
+		const int EXP_BLUR_ALPHA_PRECISION = 16;
+		const int EXP_BLUR_PARAM_PRECISION = 7;
+		
+		delegate void TileFunc (int start, int end);
+		
+		class TileJob
+		{
+			public unowned TileFunc func;
+			public int length;
+			public int count;
+			
+			int next = 0;
+			int done = 0;
+			Mutex mutex;
+			Cond cond;
+			
+			public TileJob (TileFunc _func, int _length)
+			{
+				func = _func;
+				length = _length;
+				count = (_length + TILE_SIZE - 1) / TILE_SIZE;
+			}
+			
+			/**
+			 * Process tiles until all of them are claimed.
+			 * Helpers which start late won't touch any data.
+			 */
+			public void run ()
+			{
+				int tile;
+				
+				while ((tile = AtomicInt.add (ref next, 1)) < count) {
+					var start = tile * TILE_SIZE;
+					func (start, int.min (start + TILE_SIZE, length));
+					
+					mutex.lock ();
+					if (++done == count)
+						cond.broadcast ();
+					mutex.unlock ();
+				}
+			}
+			
+			public void wait ()
+			{
+				mutex.lock ();
+				while (done < count)
+					cond.wait (mutex);
+				mutex.unlock ();
+			}
+		}
+		
+		BlurEngine ()
+		{
+		}
+		
+		/**
+		 * Performs box blur passes, each pass is horizontal followed by vertical.
+		 *
+		 * @param pixels the image data
+		 * @param width the width of the image
+		 * @param height the height of the image
+		 * @param stride the stride of the image data
+		 * @param radius the radius of the box
+		 * @param passes how many passes to run
+		 */
+		public static void box_blur (uint8* pixels, int width, int height, int stride, int radius, int passes = 1)
+		{
+			if (radius < 1 || passes < 1)
+				return;
+			
+			radius = int.min (radius, PlankBlur.MAX_BOX_RADIUS);
+			
+			while (passes-- > 0)
+				box_blur_pass (pixels, width, height, stride, radius);
+		}
+		
+		/**
+		 * Approximates a gaussian blur by three successive box blur passes.
+		 *
+		 * @param pixels the image data
+		 * @param width the width of the image
+		 * @param height the height of the image
+		 * @param stride the stride of the image data
+		 * @param sigma the standard deviation of the gaussian
+		 */
+		public static void gaussian_blur (uint8* pixels, int width, int height, int stride, double sigma)
+		{
+			if (sigma <= 0.0)
+				return;
+			
+			var ideal = Math.sqrt (12.0 * sigma * sigma / GAUSSIAN_BOX_COUNT + 1.0);
+			var lower = (int) Math.floor (ideal);
+			if (lower % 2 == 0)
+				lower--;
+			var upper = lower + 2;
+			var lower_count = (int) Math.round ((12.0 * sigma * sigma - GAUSSIAN_BOX_COUNT * lower * lower - 4 * GAUSSIAN_BOX_COUNT * lower - 3 * GAUSSIAN_BOX_COUNT) / (-4 * lower - 4));
+			
+			for (var i = 0; i < GAUSSIAN_BOX_COUNT; i++) {
+				var size = (i < lower_count ? lower : upper);
+				var radius = int.min ((size - 1) / 2, PlankBlur.MAX_BOX_RADIUS);
+				if (radius > 0)
+					box_blur_pass (pixels, width, height, stride, radius);
+			}
+		}
+		
+		/**
+		 * Performs an exponential blur.
+		 *
+		 * @param pixels the image data
+		 * @param width the width of the image
+		 * @param height the height of the image
+		 * @param stride the stride of the image data
+		 * @param radius the radius of the blur
+		 */
+		public static void exponential_blur (uint8* pixels, int width, int height, int stride, int radius)
+		{
+			if (radius < 1)
+				return;
+			
+			var alpha = (int) ((1 << EXP_BLUR_ALPHA_PRECISION) * (1.0 - Math.exp (-2.3 / (radius + 1.0))));
+			var pixel_count = width * height;
+			
+			run_tiles (height, (start, end) => {
+				exponential_blur_rows (pixels, width, stride, start, end, alpha);
+			}, pixel_count);
+			
+			run_tiles (width, (start, end) => {
+				exponential_blur_columns (pixels, height, stride, start, end, alpha);
+			}, pixel_count);
+		}
+		
+		static void box_blur_pass (uint8* pixels, int width, int height, int stride, int radius)
+		{
+			var pixel_count = width * height;
+			
+			run_tiles (height, (start, end) => {
+				PlankBlur.box_horizontal (pixels, stride, width, start, end, radius);
+			}, pixel_count);
+			
+			run_tiles (width, (start, end) => {
+				PlankBlur.box_vertical (pixels, stride, height, start, end, radius);
+			}, pixel_count);
+		}
+		
+		static void run_tiles (int length, TileFunc func, int pixel_count)
+		{
+			if (length <= TILE_SIZE || pixel_count < PARALLEL_MIN_PIXELS) {
+				func (0, length);
+				return;
+			}
+			
+			var job = new TileJob (func, length);
+			var helpers = int.min (job.count, (int) GLib.get_num_processors ()) - 1;
+			
+			unowned Worker worker = Worker.get_default ();
+			for (var i = 0; i < helpers; i++)
+				worker.add_task (() => {
+					job.run ();
+					return null;
+				}, TaskPriority.HIGH);
+			
+			job.run ();
+			job.wait ();
+		}
+		
+		static void exponential_blur_columns (uint8* pixels, int height, int stride, int start_col, int end_col, int alpha)
+		{
+			for (var x = start_col; x < end_col; x++) {
+				uint8* column = pixels + x * 4;
+				
+				var zA = column[0] << EXP_BLUR_PARAM_PRECISION;
+				var zR = column[1] << EXP_BLUR_PARAM_PRECISION;
+				var zG = column[2] << EXP_BLUR_PARAM_PRECISION;
+				var zB = column[3] << EXP_BLUR_PARAM_PRECISION;
+				
+				// Top to Bottom
+				for (var y = 1; y < height - 1; y++)
+					exponential_blur_inner (column + y * stride, ref zA, ref zR, ref zG, ref zB, alpha);
+				
+				// Bottom to Top
+				for (var y = height - 2; y >= 0; y--)
+					exponential_blur_inner (column + y * stride, ref zA, ref zR, ref zG, ref zB, alpha);
+			}
+		}
+		
+		static void exponential_blur_rows (uint8* pixels, int width, int stride, int start_row, int end_row, int alpha)
+		{
+			for (var y = start_row; y < end_row; y++) {
+				uint8* row = pixels + y * stride;
+				
+				var zA = row[0] << EXP_BLUR_PARAM_PRECISION;
+				var zR = row[1] << EXP_BLUR_PARAM_PRECISION;
+				var zG = row[2] << EXP_BLUR_PARAM_PRECISION;
+				var zB = row[3] << EXP_BLUR_PARAM_PRECISION;
+				
+				// Left to Right
+				for (var x = 1; x < width; x++)
+					exponential_blur_inner (row + x * 4, ref zA, ref zR, ref zG, ref zB, alpha);
+				
+				// Right to Left
+				for (var x = width - 2; x >= 0; x--)
+					exponential_blur_inner (row + x * 4, ref zA, ref zR, ref zG, ref zB, alpha);
+			}
+		}
+		
+		static inline void exponential_blur_inner (uint8* pixel, ref int zA, ref int zR, ref int zG, ref int zB, int alpha)
+		{
+			zA += (alpha * ((pixel[0] << EXP_BLUR_PARAM_PRECISION) - zA)) >> EXP_BLUR_ALPHA_PRECISION;
+			zR += (alpha * ((pixel[1] << EXP_BLUR_PARAM_PRECISION) - zR)) >> EXP_BLUR_ALPHA_PRECISION;
+			zG += (alpha * ((pixel[2] << EXP_BLUR_PARAM_PRECISION) - zG)) >> EXP_BLUR_ALPHA_PRECISION;
+			zB += (alpha * ((pixel[3] << EXP_BLUR_PARAM_PRECISION) - zB)) >> EXP_BLUR_ALPHA_PRECISION;
+			
+			pixel[0] = (uint8) (zA >> EXP_BLUR_PARAM_PRECISION);
+			pixel[1] = (uint8) (zR >> EXP_BLUR_PARAM_PRECISION);
+			pixel[2] = (uint8) (zG >> EXP_BLUR_PARAM_PRECISION);
+			pixel[3] = (uint8) (zB >> EXP_BLUR_PARAM_PRECISION);
+		}
+	}
+}
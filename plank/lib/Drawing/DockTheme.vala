@@ -328,6 +328,9 @@ namespace Plank
 				break;
 			}
 			
+			// keep any clip of the caller intact
+			cr.save ();
+			
 			cr.save ();
 			cr.rotate (rotate);
 			cr.translate (xoffset, yoffset);
@@ -347,7 +350,7 @@ namespace Plank
 			cr.set_source (gradient);
 			cr.fill ();
 			
-			cr.reset_clip ();
+			cr.restore ();
 		}
 		
 		/**
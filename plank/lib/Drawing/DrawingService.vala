@@ -331,6 +331,90 @@ namespace Plank
 			return surface;
 		}
 		
+		/**
+		 * Finds the file of the first available icon of the given names.
+		 *
+		 * This uses the icon theme, so only call it from the main thread.
+		 *
+		 * @param names a delimited (with ";;") list of icon names, first one found is used
+		 * @param width the requested width of the icon
+		 * @param height the requested height of the icon
+		 * @param scale the implicit requested scale of the icon
+		 * @return the {@link GLib.File} of the icon, the internal default icon as last resort
+		 */
+		internal static File lookup_icon_file (string names, int width, int height, int scale)
+		{
+			var all_names = names.split (";;");
+			all_names += DEFAULT_ICON;
+			
+			foreach (unowned string name in all_names) {
+				var file = try_get_icon_file (name);
+				if (file != null)
+					return file;
+				
+				var filename = lookup_icon_filename (name, int.max (width, height) / scale, scale);
+				if (filename == null && name.contains ("."))
+					filename = lookup_icon_filename (name.split (".")[0], int.max (width, height) / scale, scale);
+				if (filename != null)
+					return File.new_for_path (filename);
+				
+				if (name != DEFAULT_ICON)
+					message ("Could not find icon '%s'", name);
+			}
+			
+			return get_default_icon_file ();
+		}
+		
+		/**
+		 * @return the {@link GLib.File} of the internal default icon
+		 */
+		internal static File get_default_icon_file ()
+		{
+			return File.new_for_uri ("resource://" + Plank.G_RESOURCE_PATH + "/img/application-default-icon.svg");
+		}
+		
+		static string? lookup_icon_filename (string icon, int size, int scale)
+		{
+			string? filename = null;
+			unowned Gtk.IconTheme icon_theme = get_icon_theme ();
+			
+			icon_theme_mutex.lock ();
+			
+			var info = icon_theme.lookup_icon_for_scale (icon, size, scale, Gtk.IconLookupFlags.FORCE_SIZE);
+			// Built-in icons don't have a file
+			if (info != null)
+				filename = info.get_filename ();
+			
+			icon_theme_mutex.unlock ();
+			
+			return filename;
+		}
+		
+		/**
+		 * Loads an icon file centered on a surface of the given size, maintaining
+		 * its aspect ratio.
+		 *
+		 * This doesn't touch the icon theme and may be called from any thread.
+		 *
+		 * @param file the icon file, e.g. found by lookup_icon_file ()
+		 * @param width the width of the surface
+		 * @param height the height of the surface
+		 * @return the surface with a device-scale of 1, or null if the file couldn't be loaded
+		 */
+		internal static Cairo.ImageSurface? load_icon_file (File file, int width, int height)
+		{
+			var pbuf = load_pixbuf_from_file (file, width, height);
+			if (pbuf == null)
+				return null;
+			
+			var surface = new Cairo.ImageSurface (Cairo.Format.ARGB32, width, height);
+			var cr = new Cairo.Context (surface);
+			Gdk.cairo_set_source_pixbuf (cr, pbuf, (width - pbuf.width) / 2, (height - pbuf.height) / 2);
+			cr.paint ();
+			
+			return surface;
+		}
+		
 		/**
 		 * Scales a {@link Gdk.Pixbuf}, maintaining the original aspect ratio.
 		 *
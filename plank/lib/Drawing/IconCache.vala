@@ -0,0 +1,267 @@
+//
+//  Copyright (C) 2026 The Plank Developers
+//
+//  This file is part of Plank.
+//
+//  Plank is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Plank is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+namespace Plank
+{
+	/**
+	 * Persists rendered icons in the user's cache folder.
+	 *
+	 * Every entry is a file holding a small header with the icon's average
+	 * color, followed by its premultiplied ARGB32 pixels, and is read through
+	 * a memory mapping.  Entries are keyed by the icon theme, the icon names,
+	 * the size and scale, so they can be found without resolving the names
+	 * through the icon theme.
+	 *
+	 * All methods may be called from worker threads.
+	 */
+	internal class IconCache : GLib.Object
+	{
+		// "PIC1"
+		const uint32 MAGIC = 0x50494331;
+		const string FILE_SUFFIX = ".icon";
+		const int MAX_ENTRIES = 1024;
+		
+		struct Header
+		{
+			public uint32 magic;
+			public int32 width;
+			public int32 height;
+			public int32 stride;
+			public double red;
+			public double green;
+			public double blue;
+			public double alpha;
+		}
+		
+		IconCache ()
+		{
+		}
+		
+		static File? get_folder ()
+		{
+			if (Paths.AppCacheFolder == null)
+				return null;
+			
+			return Paths.AppCacheFolder.get_child ("icons");
+		}
+		
+		static string get_names_prefix (string names)
+		{
+			return "%s-".printf (Checksum.compute_for_string (ChecksumType.MD5, names));
+		}
+		
+		static string get_file_name (string names, string key)
+		{
+			return "%s%s%s".printf (get_names_prefix (names), Checksum.compute_for_string (ChecksumType.MD5, key), FILE_SUFFIX);
+		}
+		
+		/**
+		 * Creates the key of an icon, this queries the modification time of icon names
+		 * which are paths, so changed files don't serve stale icons.
+		 *
+		 * @param theme_key identifies the current icon theme
+		 * @param names a delimited (with ";;") list of icon names
+		 * @param width the width of the icon
+		 * @param height the height of the icon
+		 * @param scale the scale of the icon
+		 * @return the key of the icon
+		 */
+		public static string get_key (string theme_key, string names, int width, int height, int scale)
+		{
+			var key = new StringBuilder ();
+			key.append_printf ("%s|%i|%i|%i|%s", theme_key, width, height, scale, names);
+			
+			foreach (unowned string name in names.split (";;")) {
+				var file = DrawingService.try_get_icon_file (name);
+				if (file == null || !file.is_native ())
+					continue;
+				
+				try {
+					var info = file.query_info (FileAttribute.TIME_MODIFIED, FileQueryInfoFlags.NONE);
+					if (info.has_attribute (FileAttribute.TIME_MODIFIED))
+						key.append_printf ("|%s@%" + uint64.FORMAT, name, info.get_attribute_uint64 (FileAttribute.TIME_MODIFIED));
+				} catch { }
+			}
+			
+			return key.str;
+		}
+		
+		/**
+		 * Reads an icon from the cache.
+		 *
+		 * @param names the icon names the key was created for
+		 * @param key the key of the icon
+		 * @param color the average color of the icon
+		 * @return the icon, or null if it isn't cached
+		 */
+		public static Cairo.ImageSurface? load (string names, string key, out Color color)
+		{
+			color = Color () { red = 0.0, green = 0.0, blue = 0.0, alpha = 0.0 };
+			
+			var folder = get_folder ();
+			if (folder == null)
+				return null;
+			
+			var path = folder.get_child (get_file_name (names, key)).get_path ();
+			if (!FileUtils.test (path, FileTest.IS_REGULAR))
+				return null;
+			
+			MappedFile mapped;
+			try {
+				mapped = new MappedFile (path, false);
+			} catch (FileError e) {
+				debug ("Could not map cached icon '%s' (%s)", path, e.message);
+				return null;
+			}
+			
+			var length = mapped.get_length ();
+			if (length < sizeof (Header))
+				return null;
+			
+			uint8* data = mapped.get_contents ();
+			Header header = {};
+			Memory.copy (&header, data, sizeof (Header));
+			
+			if (header.magic != MAGIC || header.width <= 0 || header.height <= 0 || header.stride < header.width * 4
+				|| length < sizeof (Header) + (size_t) header.stride * header.height) {
+				FileUtils.unlink (path);
+				return null;
+			}
+			
+			var icon = new Cairo.ImageSurface (Cairo.Format.ARGB32, header.width, header.height);
+			uint8* pixels = icon.get_data ();
+			var stride = icon.get_stride ();
+			uint8* source = data + sizeof (Header);
+			
+			icon.flush ();
+			for (var y = 0; y < header.height; y++)
+				Memory.copy (pixels + y * stride, source + y * header.stride, header.width * 4);
+			icon.mark_dirty ();
+			
+			color = Color () { red = header.red, green = header.green, blue = header.blue, alpha = header.alpha };
+			
+			return icon;
+		}
+		
+		/**
+		 * Writes an icon to the cache.
+		 *
+		 * @param names the icon names the key was created for
+		 * @param key the key of the icon
+		 * @param icon the icon
+		 * @param color the average color of the icon
+		 * @return whether the icon was written
+		 */
+		public static bool store (string names, string key, Cairo.ImageSurface icon, Color color)
+		{
+			var folder = get_folder ();
+			if (folder == null || !Paths.ensure_directory_exists (folder))
+				return false;
+			
+			icon.flush ();
+			
+			var stride = icon.get_stride ();
+			var height = icon.get_height ();
+			var header = Header () {
+				magic = MAGIC,
+				width = icon.get_width (),
+				height = height,
+				stride = stride,
+				red = color.red,
+				green = color.green,
+				blue = color.blue,
+				alpha = color.alpha
+			};
+			
+			var data = new uint8[sizeof (Header) + (size_t) stride * height];
+			Memory.copy (data, &header, sizeof (Header));
+			Memory.copy ((uint8*) data + sizeof (Header), icon.get_data (), (size_t) stride * height);
+			
+			var path = folder.get_child (get_file_name (names, key)).get_path ();
+			try {
+				FileUtils.set_data (path, data);
+			} catch (FileError e) {
+				debug ("Could not write cached icon '%s' (%s)", path, e.message);
+				return false;
+			}
+			
+			return true;
+		}
+		
+		/**
+		 * Removes all entries of the given icon names.
+		 *
+		 * @param names a delimited (with ";;") list of icon names
+		 */
+		public static void invalidate (string names)
+		{
+			delete_entries (get_names_prefix (names), 0);
+		}
+		
+		/**
+		 * Removes all entries.
+		 */
+		public static void clear ()
+		{
+			delete_entries (null, 0);
+		}
+		
+		/**
+		 * Removes the least recently written entries exceeding the limit.
+		 */
+		public static void prune ()
+		{
+			delete_entries (null, MAX_ENTRIES);
+		}
+		
+		static void delete_entries (string? prefix, int keep)
+		{
+			var folder = get_folder ();
+			if (folder == null)
+				return;
+			
+			var entries = new Gee.ArrayList<FileInfo> ();
+			
+			try {
+				var enumerator = folder.enumerate_children (FileAttribute.STANDARD_NAME + "," + FileAttribute.TIME_MODIFIED, FileQueryInfoFlags.NONE);
+				FileInfo? info;
+				while ((info = enumerator.next_file ()) != null) {
+					unowned string name = info.get_name ();
+					if (name.has_suffix (FILE_SUFFIX) && (prefix == null || name.has_prefix (prefix)))
+						entries.add (info);
+				}
+			} catch (Error e) {
+				return;
+			}
+			
+			if (entries.size <= keep)
+				return;
+			
+			// Newest first
+			entries.sort ((a, b) => {
+				var time_a = a.get_attribute_uint64 (FileAttribute.TIME_MODIFIED);
+				var time_b = b.get_attribute_uint64 (FileAttribute.TIME_MODIFIED);
+				return (time_a > time_b ? -1 : (int) (time_a < time_b));
+			});
+			
+			for (var i = keep; i < entries.size; i++)
+				FileUtils.unlink (folder.get_child (entries[i].get_name ()).get_path ());
+		}
+	}
+}
@@ -0,0 +1,376 @@
+//
+//  Copyright (C) 2026 The Plank Developers
+//
+//  This file is part of Plank.
+//
+//  Plank is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Plank is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+namespace Plank
+{
+	/**
+	 * Loads and scales item icons on the {@link Worker} pool.
+	 *
+	 * Workers look up the {@link IconCache} first, only on a miss the icon
+	 * names are resolved to a file on the main thread, as the icon theme
+	 * isn't thread-safe, and workers decode and scale it.  Files which fail
+	 * to load are replaced by the default icon.
+	 *
+	 * Items draw a placeholder until their icon is ready, finished icons
+	 * are handed back to the waiting items in small batches to not stall
+	 * a frame with many items redrawing at once.
+	 *
+	 * Named icons are persisted in the {@link IconCache}.
+	 */
+	internal class IconLoader : GLib.Object
+	{
+		const uint SWAP_INTERVAL = 16;
+		const int MAX_SWAPS_PER_INTERVAL = 4;
+		const int64 UNCLAIMED_ICON_LIFETIME = 10 * 1000 * 1000;
+		const uint STORES_PER_PRUNE = 64U;
+		
+		class Request
+		{
+			public string names;
+			// Keeps the pixbuf alive, its address is part of the request's key
+			public Gdk.Pixbuf? pixbuf;
+			public Gee.HashSet<DockItem> items = new Gee.HashSet<DockItem> ();
+			public Cairo.Surface? icon = null;
+			public Color color;
+			public Cancellable cancellable = new Cancellable ();
+			public bool finished = false;
+			public int64 finish_time = 0LL;
+			
+			public Request (string _names, Gdk.Pixbuf? _pixbuf)
+			{
+				names = _names;
+				pixbuf = _pixbuf;
+			}
+		}
+		
+		class LoadedIcon
+		{
+			public string? key;
+			public Cairo.ImageSurface? icon;
+			public Color color;
+			public bool stored = false;
+			
+			public LoadedIcon (string? _key, Cairo.ImageSurface? _icon, Color _color)
+			{
+				key = _key;
+				icon = _icon;
+				color = _color;
+			}
+		}
+		
+		static IconLoader? instance = null;
+		
+		public static unowned IconLoader get_default ()
+		{
+			if (instance == null)
+				instance = new IconLoader ();
+			
+			return instance;
+		}
+		
+		Gee.HashMap<string, Request> requests;
+		Gee.ArrayList<Request> finished_requests;
+		uint swap_timer_id = 0U;
+		uint stores_since_prune = 0U;
+		string theme_key;
+		
+		IconLoader ()
+		{
+			Object ();
+		}
+		
+		construct
+		{
+			requests = new Gee.HashMap<string, Request> ();
+			finished_requests = new Gee.ArrayList<Request> ();
+			
+			theme_key = get_theme_key ();
+			DrawingService.get_icon_theme ().changed.connect (icon_theme_changed);
+			
+			Worker.get_default ().add_task (() => {
+				IconCache.prune ();
+				return null;
+			}, TaskPriority.LOW);
+		}
+		
+		~IconLoader ()
+		{
+			DrawingService.get_icon_theme ().changed.disconnect (icon_theme_changed);
+			
+			if (swap_timer_id > 0U) {
+				GLib.Source.remove (swap_timer_id);
+				swap_timer_id = 0U;
+			}
+		}
+		
+		/**
+		 * Returns the icon if it was loaded already, otherwise schedules
+		 * loading it and notifies the item once it is available.
+		 *
+		 * @param item the item requesting the icon
+		 * @param names a delimited (with ";;") list of icon names
+		 * @param pixbuf a pixbuf to use instead of the named icons, or null
+		 * @param width the requested width of the icon
+		 * @param height the requested height of the icon
+		 * @param scale the implicit requested scale of the icon
+		 * @param persist whether the icon may be stored in the {@link IconCache}
+		 * @param color the average color of the icon
+		 * @return the icon with a device-scale of 1, or null if it isn't available yet
+		 */
+		public Cairo.Surface? get_icon (DockItem item, string names, Gdk.Pixbuf? pixbuf, int width, int height, int scale, bool persist, out Color color)
+		{
+			color = Color () { red = 0.0, green = 0.0, blue = 0.0, alpha = 0.0 };
+			
+			string key;
+			if (pixbuf != null)
+				key = "pixbuf:%p:%i:%i".printf (pixbuf, width, height);
+			else
+				key = "%s:%i:%i:%i".printf (names, width, height, scale);
+			
+			var request = requests.get (key);
+			if (request != null && request.finished) {
+				// Keep the icon around until all waiting items picked it up
+				request.items.remove (item);
+				if (request.items.size == 0) {
+					requests.unset (key);
+					finished_requests.remove (request);
+				}
+				color = request.color;
+				return request.icon;
+			}
+			
+			if (request == null) {
+				purge_unclaimed ();
+				request = new Request (names, pixbuf);
+				requests.set (key, request);
+				load.begin (request, theme_key, names, pixbuf, width, height, scale, persist);
+			}
+			
+			request.items.add (item);
+			
+			return null;
+		}
+		
+		/**
+		 * Forget about the given icon names, e.g. because the icon file changed.
+		 *
+		 * @param names a delimited (with ";;") list of icon names
+		 */
+		public void invalidate (string names)
+		{
+			var requests_it = requests.map_iterator ();
+			while (requests_it.next ()) {
+				var request = requests_it.get_value ();
+				if (request.names != names)
+					continue;
+				
+				request.cancellable.cancel ();
+				finished_requests.remove (request);
+				requests_it.unset ();
+			}
+			
+			Worker.get_default ().add_task (() => {
+				IconCache.invalidate (names);
+				return null;
+			}, TaskPriority.LOW);
+		}
+		
+		async void load (Request request, string theme_key, string names, Gdk.Pixbuf? pixbuf, int width, int height, int scale, bool persist)
+		{
+			unowned Worker worker = Worker.get_default ();
+			LoadedIcon? loaded = null;
+			
+			try {
+				if (persist && pixbuf == null)
+					loaded = yield worker.add_cancellable_task_with_result<LoadedIcon> (() => {
+						return load_cached_icon (theme_key, names, width, height, scale);
+					}, TaskPriority.DEFAULT, request.cancellable);
+				
+				// Only hit the icon theme if the icon wasn't cached
+				if (loaded == null || loaded.icon == null) {
+					var key = (loaded != null ? loaded.key : null);
+					var file = (pixbuf == null ? DrawingService.lookup_icon_file (names, width, height, scale) : null);
+					loaded = yield worker.add_cancellable_task_with_result<LoadedIcon?> (() => {
+						return load_icon (names, key, file, pixbuf, width, height);
+					}, TaskPriority.DEFAULT, request.cancellable);
+				}
+			} catch (IOError.CANCELLED e) {
+				return;
+			} catch (Error e) {
+				warning (e.message);
+			}
+			
+			if (loaded != null) {
+				request.icon = loaded.icon;
+				request.color = loaded.color;
+				
+				// Keep the cache within its limits during long sessions too
+				if (loaded.stored && ++stores_since_prune >= STORES_PER_PRUNE) {
+					stores_since_prune = 0U;
+					Worker.get_default ().add_task (() => {
+						IconCache.prune ();
+						return null;
+					}, TaskPriority.LOW);
+				}
+			}
+			request.finished = true;
+			request.finish_time = GLib.get_monotonic_time ();
+			finished_requests.add (request);
+			
+			if (swap_timer_id == 0U)
+				swap_timer_id = Gdk.threads_add_timeout (SWAP_INTERVAL, (SourceFunc) swap_finished);
+		}
+		
+		/**
+		 * Runs on a worker thread.
+		 */
+		static LoadedIcon load_cached_icon (string theme_key, string names, int width, int height, int scale)
+		{
+			Color color;
+			
+			var key = IconCache.get_key (theme_key, names, width, height, scale);
+			var icon = IconCache.load (names, key, out color);
+			
+			return new LoadedIcon (key, icon, color);
+		}
+		
+		/**
+		 * Runs on a worker thread.
+		 */
+		static LoadedIcon? load_icon (string names, string? key, File? file, Gdk.Pixbuf? pixbuf, int width, int height)
+		{
+			var icon = render_icon (file, pixbuf, width, height);
+			
+			// Broken or unsupported files get the default icon, but it isn't persisted
+			// so a fixed file is picked up again
+			if (icon == null) {
+				message ("Could not load icon '%s'", file.get_uri ());
+				icon = DrawingService.load_icon_file (DrawingService.get_default_icon_file (), width, height);
+				if (icon == null)
+					return null;
+				key = null;
+			}
+			
+			var color = new Surface.with_internal (icon).average_color ();
+			
+			var loaded = new LoadedIcon (key, icon, color);
+			if (key != null)
+				loaded.stored = IconCache.store (names, key, icon, color);
+			
+			return loaded;
+		}
+		
+		static Cairo.ImageSurface? render_icon (File? file, Gdk.Pixbuf? pixbuf, int width, int height)
+		{
+			if (pixbuf == null)
+				return (file != null ? DrawingService.load_icon_file (file, width, height) : null);
+			
+			var image = new Cairo.ImageSurface (Cairo.Format.ARGB32, width, height);
+			var cr = new Cairo.Context (image);
+			var pbuf = DrawingService.ar_scale (pixbuf, width, height);
+			Gdk.cairo_set_source_pixbuf (cr, pbuf, (width - pbuf.width) / 2, (height - pbuf.height) / 2);
+			cr.paint ();
+			
+			return image;
+		}
+		
+		bool swap_finished ()
+		{
+			var count = 0;
+			
+			while (count < MAX_SWAPS_PER_INTERVAL && finished_requests.size > 0) {
+				var request = finished_requests.remove_at (0);
+				
+				// Items stay listed until they picked up the icon in get_icon ()
+				foreach (var item in request.items.to_array ())
+					item.icon_loaded ();
+				
+				count++;
+			}
+			
+			if (finished_requests.size > 0)
+				return true;
+			
+			swap_timer_id = 0U;
+			purge_unclaimed ();
+			
+			return false;
+		}
+		
+		/**
+		 * Drop icons which were not picked up by their items, e.g. because
+		 * the item was removed or requires a different size by now.
+		 */
+		void purge_unclaimed ()
+		{
+			var now = GLib.get_monotonic_time ();
+			
+			var requests_it = requests.map_iterator ();
+			while (requests_it.next ()) {
+				var request = requests_it.get_value ();
+				if (request.finished && now - request.finish_time > UNCLAIMED_ICON_LIFETIME)
+					requests_it.unset ();
+			}
+		}
+		
+		/**
+		 * Identifies the current icon theme and its state, so the {@link IconCache}
+		 * doesn't serve icons of a theme which was updated in between sessions.
+		 *
+		 * This uses the icon theme, so only call it from the main thread.
+		 */
+		static string get_theme_key ()
+		{
+			var theme_name = Gtk.Settings.get_default ().gtk_icon_theme_name ?? "";
+			var key = new StringBuilder (theme_name);
+			
+			string[] search_path;
+			DrawingService.get_icon_theme ().get_search_path (out search_path);
+			
+			// Installing icons updates the caches of the themes
+			foreach (unowned string path in search_path) {
+				foreach (unowned string name in (new string[] { theme_name, "hicolor" })) {
+					var file = File.new_for_path (Path.build_filename (path, name, "icon-theme.cache"));
+					try {
+						var info = file.query_info (FileAttribute.TIME_MODIFIED, FileQueryInfoFlags.NONE);
+						key.append_printf ("|%" + uint64.FORMAT, info.get_attribute_uint64 (FileAttribute.TIME_MODIFIED));
+					} catch { }
+				}
+			}
+			
+			return key.str;
+		}
+		
+		void icon_theme_changed ()
+		{
+			theme_key = get_theme_key ();
+			
+			foreach (var request in requests.values)
+				request.cancellable.cancel ();
+			
+			requests.clear ();
+			finished_requests.clear ();
+			
+			Worker.get_default ().add_task (() => {
+				IconCache.clear ();
+				return null;
+			}, TaskPriority.LOW);
+		}
+	}
+}
@@ -22,9 +22,21 @@ namespace Plank
 	/**
 	 * Handles animated rendering.  Uses a timer and continues requesting
 	 * redraws for a widget until no more animation is needed.
+	 *
+	 * Requests are coalesced into the next frame of the widget's frame-clock.
+	 * The cost of every frame is measured and the animation rate is lowered
+	 * while running on battery or if frames are too expensive to keep up
+	 * with the refresh rate.
 	 */
 	public abstract class Renderer : GLib.Object
 	{
+		const int64 DEFAULT_REFRESH_INTERVAL = 16667;
+		// Ratios of the average frame cost to the refresh interval to leave/enter the reduced rate
+		const double FAST_FRAME_RATIO = 0.35;
+		const double SLOW_FRAME_RATIO = 0.75;
+		// Weight of the latest measurement in the running averages
+		const double AVERAGE_WEIGHT = 0.125;
+		
 		public Gtk.Widget widget { get; construct; }
 		
 		[CCode (notify = false)]
@@ -34,6 +46,22 @@ namespace Plank
 		ulong widget_realize_handler_id = 0UL;
 		ulong widget_draw_handler_id = 0UL;
 		bool is_updating = false;
+		bool frame_requested = false;
+		bool is_animating = false;
+		bool is_slow = false;
+		
+		int64 last_frame_time = 0LL;
+		int64 refresh_interval = DEFAULT_REFRESH_INTERVAL;
+		int frame_divisor = 1;
+		
+		uint64 frame_count = 0ULL;
+		uint64 skipped_frames = 0ULL;
+		uint64 missed_frames = 0ULL;
+		uint64 coalesced_requests = 0ULL;
+		int64 last_initialize_time = 0LL;
+		int64 last_draw_time = 0LL;
+		double average_initialize_time = 0.0;
+		double average_draw_time = 0.0;
 		
 		/**
 		 * Creates a new animation renderer.
@@ -90,6 +118,17 @@ namespace Plank
 		 */
 		public abstract void draw (Cairo.Context cr, int64 frame_time);
 		
+		/**
+		 * Determines the region of the widget which changed with the
+		 * most recently initialized frame.
+		 *
+		 * @return the damaged region, or null if the whole widget needs a redraw
+		 */
+		protected virtual Cairo.Region? get_damage_region ()
+		{
+			return null;
+		}
+		
 		/**
 		 * Force an immediate update of the frame_time property.
 		 */
@@ -100,32 +139,120 @@ namespace Plank
 		
 		/**
 		 * Request re-drawing.
+		 *
+		 * All requests until the next frame of the widget are handled at once.
 		 */
 		public void animated_draw ()
 		{
-			if (is_updating || !widget.get_realized ())
+			if (!widget.get_realized ())
 				return;
 			
-			force_frame_time_update ();
+			if (frame_requested) {
+				coalesced_requests++;
+				return;
+			}
+			
+			frame_requested = true;
+			
+			if (is_updating)
+				return;
+			
+			unowned Gdk.FrameClock? frame_clock = widget.get_frame_clock ();
+			frame_clock.begin_updating ();
+			is_updating = true;
+		}
+		
+		/**
+		 * Returns the timings of the recent frames, times are given in microseconds.
+		 *
+		 * @return a dictionary of the timings and counters
+		 */
+		public HashTable<string, Variant> get_frame_stats ()
+		{
+			var stats = new HashTable<string, Variant> (str_hash, str_equal);
+			
+			stats.insert ("frames", new Variant.uint64 (frame_count));
+			stats.insert ("skipped-frames", new Variant.uint64 (skipped_frames));
+			stats.insert ("missed-frames", new Variant.uint64 (missed_frames));
+			stats.insert ("coalesced-requests", new Variant.uint64 (coalesced_requests));
+			stats.insert ("initialize-time", new Variant.int64 (last_initialize_time));
+			stats.insert ("draw-time", new Variant.int64 (last_draw_time));
+			stats.insert ("average-initialize-time", new Variant.double (average_initialize_time));
+			stats.insert ("average-draw-time", new Variant.double (average_draw_time));
+			stats.insert ("refresh-interval", new Variant.int64 (refresh_interval));
+			stats.insert ("frame-interval", new Variant.int64 (refresh_interval * frame_divisor));
+			
+			return stats;
+		}
+		
+		void timed_initialize_frame ()
+		{
+			var start = GLib.get_monotonic_time ();
 			initialize_frame (frame_time);
+			last_initialize_time = GLib.get_monotonic_time () - start;
+			average_initialize_time += (last_initialize_time - average_initialize_time) * AVERAGE_WEIGHT;
+		}
+		
+		void update_frame_divisor (Gdk.FrameClock frame_clock)
+		{
+			int64 interval, presentation_time;
+			frame_clock.get_refresh_info (frame_clock.get_frame_time (), out interval, out presentation_time);
+			refresh_interval = (interval > 0 ? interval : DEFAULT_REFRESH_INTERVAL);
 			
-			widget.queue_draw ();
+			var frame_cost = average_initialize_time + average_draw_time;
+			if (frame_cost > refresh_interval * SLOW_FRAME_RATIO)
+				is_slow = true;
+			else if (frame_cost < refresh_interval * FAST_FRAME_RATIO)
+				is_slow = false;
 			
-			if (animation_needed (frame_time)) {
-				unowned Gdk.FrameClock? frame_clock = widget.get_frame_clock ();
-				frame_clock.begin_updating ();
-				is_updating = true;
-			}
+			frame_divisor = 1;
+			if (EnvironmentSettings.get_instance ().OnBattery)
+				frame_divisor *= 2;
+			if (is_slow)
+				frame_divisor *= 2;
+		}
+		
+		void queue_damage ()
+		{
+			var damage = get_damage_region ();
+			
+			if (damage == null)
+				widget.queue_draw ();
+			else if (!damage.is_empty ())
+				widget.queue_draw_region (damage);
 		}
 		
 		[CCode (instance_pos = -1)]
 		bool draw_timeout (Gtk.Widget widget, Gdk.FrameClock frame_clock)
 		{
-			frame_time = GLib.get_monotonic_time ();
-			initialize_frame (frame_time);
-			widget.queue_draw ();
+			if (!is_updating)
+				return true;
+			
+			var now = GLib.get_monotonic_time ();
+			update_frame_divisor (frame_clock);
+			
+			// Drop ticks of a running animation to lower its rate, allow some jitter of the frame-clock
+			var frame_interval = refresh_interval * frame_divisor;
+			if (is_animating) {
+				var elapsed = now - last_frame_time;
+				if (elapsed < frame_interval - refresh_interval / 2) {
+					skipped_frames++;
+					return true;
+				}
+				if (elapsed > frame_interval + refresh_interval / 2)
+					missed_frames++;
+			}
 			
-			if (animation_needed (frame_time))
+			frame_time = now;
+			last_frame_time = now;
+			frame_requested = false;
+			frame_count++;
+			
+			timed_initialize_frame ();
+			queue_damage ();
+			
+			is_animating = animation_needed (frame_time);
+			if (is_animating || frame_requested)
 				return true;
 			
 			frame_clock.end_updating ();
@@ -136,8 +263,11 @@ namespace Plank
 		[CCode (instance_pos = -1)]
 		bool on_widget_draw (Gtk.Widget widget, Cairo.Context cr)
 		{
+			var start = GLib.get_monotonic_time ();
 			draw (cr, frame_time);
-		
+			last_draw_time = GLib.get_monotonic_time () - start;
+			average_draw_time += (last_draw_time - average_draw_time) * AVERAGE_WEIGHT;
+			
 			return Gdk.EVENT_PROPAGATE;
 		}
 		
@@ -145,7 +275,7 @@ namespace Plank
 		void on_widget_realize (Gtk.Widget widget)
 		{
 			force_frame_time_update ();
-			initialize_frame (frame_time);
+			timed_initialize_frame ();
 			
 			if (widget_realize_handler_id > 0UL) {
 				widget.disconnect (widget_realize_handler_id);
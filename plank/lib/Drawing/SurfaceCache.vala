@@ -68,270 +68,569 @@ namespace Plank
 	}
 	
 	/**
-	 * Cache multiple sizes of the assumed same image
+	 * A cached surface of a {@link Plank.SurfaceCache}, also being a node
+	 * of the least-recently-used list of the {@link Plank.SurfaceCacheBudget}.
 	 */
-	public class SurfaceCache<G> : GLib.Object
+	class SurfaceInfo
 	{
-		const int64 MAX_CACHE_AGE = 5 * 60 * 1000 * 1000;
-		const int64 MIN_DRAWING_TIME = 10 * 1000;
-		const int64 INSANE_DRAWING_TIME = 30 * 1000;
-		const int64 ACCESS_REWARD = 500 * 1000;
+		public uint16 width;
+		public uint16 height;
+		public uint access_count;
+		public int64 last_access_time;
+		public int64 drawing_time;
+		public int64 bytes;
+		public Surface surface;
+		
+		// The owning cache is holding the actual references
+		public unowned SurfaceStore? store = null;
+		public bool is_current = false;
 		
-		class SurfaceInfo
+		// Managed by SurfaceCacheBudget only
+		public SurfaceInfo? lru_next = null;
+		public unowned SurfaceInfo? lru_prev = null;
+		public bool lru_linked = false;
+		
+		public SurfaceInfo (uint16 width, uint16 height, Surface surface, int64 last_access_time, int64 drawing_time)
 		{
-			public uint16 width;
-			public uint16 height;
-			public uint access_count;
-			public int64 last_access_time;
-			public int64 drawing_time;
-			public double scale;
-			
-			public SurfaceInfo (uint16 width, uint16 height, int64 last_access_time, int64 drawing_time)
-			{
-				this.width = width;
-				this.height = height;
-				this.last_access_time = last_access_time;
-				this.drawing_time = drawing_time;
-				this.access_count = 0;
-				this.scale = 1.0;
+			this.width = width;
+			this.height = height;
+			this.surface = surface;
+			this.last_access_time = last_access_time;
+			this.drawing_time = drawing_time;
+			this.access_count = 0;
+			this.bytes = surface_bytes (surface);
+		}
+		
+		public uint key {
+			get {
+				return size_key (width, height);
 			}
+		}
+		
+		public static uint size_key (uint16 width, uint16 height)
+		{
+			return ((uint) width << 16) | height;
+		}
+		
+		static int64 surface_bytes (Surface surface)
+		{
+			int64 bytes = (int64) surface.Width * surface.Height * 4;
+#if HAVE_HIDPI
+			double x_scale, y_scale;
+			surface.Internal.get_device_scale (out x_scale, out y_scale);
+			bytes = (int64) (bytes * x_scale * y_scale);
+#endif
+			return bytes;
+		}
+	}
+	
+	/**
+	 * The entries of one {@link Plank.SurfaceCache} which are indexed by their size.
+	 */
+	class SurfaceStore
+	{
+		// Recursive since drawing a surface may end up evicting an entry of this store
+		public RecMutex mutex;
+		
+		Gee.HashMap<uint, SurfaceInfo> entries;
+		unowned SurfaceInfo? last_info = null;
+		
+		public SurfaceStore ()
+		{
+			entries = new Gee.HashMap<uint, SurfaceInfo> ();
+		}
+		
+		public int size {
+			get {
+				return entries.size;
+			}
+		}
+		
+		public SurfaceInfo? lookup (uint16 width, uint16 height, bool allow_downscale, bool allow_upscale, out bool needs_scaling)
+		{
+			needs_scaling = false;
+			
+			if (last_info != null && last_info.width == width && last_info.height == height)
+				return last_info;
+			
+			var info = entries.get (SurfaceInfo.size_key (width, height));
+			if (info != null || !(allow_downscale || allow_upscale))
+				return info;
 			
-			public static uint hash (SurfaceInfo s)
-			{
-				uint n1 = s.width, n2 = s.height;
-				return (n1 >= n2 ? n1 * n1 + n1 + n2 : n1 + n2 * n2);
+			// Prefer the smallest larger surface, otherwise the largest smaller one
+			unowned SurfaceInfo? larger = null;
+			unowned SurfaceInfo? smaller = null;
+			foreach (unowned SurfaceInfo candidate in entries.values) {
+				if (allow_downscale && candidate.width > width && candidate.height > height
+					&& (larger == null || candidate.width < larger.width))
+					larger = candidate;
+				else if (allow_upscale && candidate.width < width && candidate.height < height
+					&& (smaller == null || candidate.width > smaller.width))
+					smaller = candidate;
 			}
 			
-			public static int compare (SurfaceInfo s1, SurfaceInfo s2)
-			{
-				if (s1 == s2)
-					return 0;
-				
-				return (2 * (s1.width - s2.width) + s2.height - s2.height);
+			info = (larger ?? smaller);
+			needs_scaling = (info != null);
+			
+			return info;
+		}
+		
+		public void set_current (SurfaceInfo info)
+		{
+			if (last_info != null)
+				last_info.is_current = false;
+			
+			last_info = info;
+			info.is_current = true;
+		}
+		
+		public void add (SurfaceInfo info)
+		{
+			info.store = this;
+			entries.set (info.key, info);
+			set_current (info);
+		}
+		
+		/**
+		 * Removes the given entry if it still belongs to this store.
+		 * The budget has to be taken care of by the caller.
+		 */
+		public void remove (SurfaceInfo info)
+		{
+			mutex.lock ();
+			
+			if (entries.get (info.key) == info) {
+				if (last_info == info)
+					last_info = null;
+				info.is_current = false;
+				info.store = null;
+				entries.unset (info.key);
 			}
 			
-			public int compare_with (uint16 width, uint16 height)
-			{
-				return (2 * (this.width - width) + this.height - height);
+			mutex.unlock ();
+		}
+		
+		public void clear (SurfaceCacheBudget budget)
+		{
+			mutex.lock ();
+			
+			foreach (var info in entries.values) {
+				budget.remove (info);
+				info.store = null;
 			}
+			
+			entries.clear ();
+			last_info = null;
+			
+			mutex.unlock ();
 		}
+	}
+	
+	/**
+	 * The memory budget shared by all instances of {@link Plank.SurfaceCache}.
+	 *
+	 * Once the budget is exceeded the least recently used surfaces are evicted,
+	 * preferring large surfaces which are cheap to redraw. Additionally stale
+	 * surfaces are cleaned up periodically, more often while the caches are busy.
+	 */
+	class SurfaceCacheBudget : GLib.Object
+	{
+		const int64 DEFAULT_BUDGET = 64 * 1024 * 1024;
+		const int64 MIN_DRAWING_TIME = 10 * 1000;
+		const int64 ACCESS_REWARD = 500 * 1000;
+		const uint EVICTION_WINDOW = 8;
+		const uint MIN_CLEAN_UP_INTERVAL = 30;
+		const uint MAX_CLEAN_UP_INTERVAL = 5 * 60;
+		const uint BUSY_ACCESS_RATE = 10;
 		
-		public SurfaceCacheFlags flags { get; construct set; }
+		static SurfaceCacheBudget? instance = null;
 		
-		Gee.TreeSet<unowned SurfaceInfo> infos;
-		Gee.HashMap<SurfaceInfo, Surface> cache_map;
-		unowned SurfaceInfo? last_info;
-		Mutex cache_mutex;
+		public static unowned SurfaceCacheBudget get_default ()
+		{
+			if (instance == null)
+				instance = new SurfaceCacheBudget ();
+			
+			return instance;
+		}
+		
+		/**
+		 * The maximum amount of bytes used by all cached surfaces.
+		 */
+		public int64 budget { get; set; default = DEFAULT_BUDGET; }
 		
+		Mutex mutex;
+		SurfaceInfo? lru_head = null;
+		unowned SurfaceInfo? lru_tail = null;
+		
+		int64 bytes = 0;
+		uint entries = 0;
+		uint64 hits = 0;
+		uint64 scaled_hits = 0;
+		uint64 misses = 0;
+		uint64 evictions = 0;
+		
+		uint accesses_since_clean_up = 0;
+		uint clean_up_interval = MAX_CLEAN_UP_INTERVAL;
 		uint clean_up_timer_id = 0U;
 		
-		public SurfaceCache (SurfaceCacheFlags flags = SurfaceCacheFlags.NONE)
+		SurfaceCacheBudget ()
 		{
-			Object (flags: flags);
+			Object ();
 		}
 		
 		construct
 		{
-			infos = new Gee.TreeSet<unowned SurfaceInfo> ((CompareDataFunc) SurfaceInfo.compare);
-			cache_map = new Gee.HashMap<SurfaceInfo, Surface> ((Gee.HashDataFunc<SurfaceInfo>) SurfaceInfo.hash);
-			last_info = null;
+			schedule_clean_up ();
 			
-			//TODO Adaptive delay depending on the access rate
-			clean_up_timer_id = Gdk.threads_add_timeout (5 * 60 * 1000, () => {
-				clean_up ();
-				return true;
-			});
+			notify["budget"].connect (() => enforce ());
 		}
 		
-		~SurfaceCache ()
+		~SurfaceCacheBudget ()
 		{
 			if (clean_up_timer_id > 0U) {
 				GLib.Source.remove (clean_up_timer_id);
 				clean_up_timer_id = 0U;
 			}
+		}
+		
+		void link (SurfaceInfo info)
+		{
+			info.lru_prev = null;
+			info.lru_next = (owned) lru_head;
+			if (info.lru_next != null)
+				info.lru_next.lru_prev = info;
+			else
+				lru_tail = info;
 			
-			cache_map.clear ();
-			infos.clear ();
-			last_info = null;
+			lru_head = info;
+			info.lru_linked = true;
 		}
 		
-		public Surface? get_surface<G> (int width, int height, Surface model, DrawFunc<G> draw_func, DrawDataFunc<G>? draw_data_func)
-			requires (width >= 0 && height >= 0)
+		void unlink (SurfaceInfo info)
 		{
-			cache_mutex.lock ();
+			// Keep a reference while the list is reorganized
+			var keep = info;
 			
-			unowned SurfaceInfo? info;
-			SurfaceInfo? current_info = null;
-			Surface? surface = null;
-			bool needs_scaling = false;
+			if (info.lru_next != null)
+				info.lru_next.lru_prev = info.lru_prev;
+			else
+				lru_tail = info.lru_prev;
 			
-			info = find_match ((uint16) width, (uint16) height, out needs_scaling);
-			last_info = info;
-			current_info = info;
+			if (info.lru_prev != null)
+				info.lru_prev.lru_next = (owned) info.lru_next;
+			else
+				lru_head = (owned) info.lru_next;
 			
-			var access_time = GLib.get_monotonic_time ();
+			keep.lru_next = null;
+			keep.lru_prev = null;
+			keep.lru_linked = false;
+		}
+		
+		/**
+		 * Accounts a newly drawn surface, call it while holding the lock of its
+		 * store and {@link enforce} once that is released.
+		 */
+		public void add (SurfaceInfo info)
+		{
+			mutex.lock ();
+			
+			link (info);
+			bytes += info.bytes;
+			entries++;
+			misses++;
+			accesses_since_clean_up++;
+			
+			mutex.unlock ();
+		}
+		
+		/**
+		 * Marks a cached surface as recently used.
+		 */
+		public void touch (SurfaceInfo info, bool scaled)
+		{
+			mutex.lock ();
+			
+			if (info.lru_linked && lru_head != info) {
+				unlink (info);
+				link (info);
+			}
+			
+			if (scaled)
+				scaled_hits++;
+			else
+				hits++;
+			accesses_since_clean_up++;
+			
+			mutex.unlock ();
+		}
+		
+		/**
+		 * Stops accounting a surface which was removed by its cache.
+		 */
+		public void remove (SurfaceInfo info)
+		{
+			mutex.lock ();
+			
+			if (info.lru_linked) {
+				unlink (info);
+				bytes -= info.bytes;
+				entries--;
+			}
+			
+			mutex.unlock ();
+		}
+		
+		unowned SurfaceInfo? pick_victim (int64 now)
+		{
+			unowned SurfaceInfo? victim = null;
+			double victim_score = 0.0;
+			uint window = 0;
 			
-			if (current_info != null) {
-				current_info.last_access_time = access_time;
-				current_info.access_count++;
-				surface = cache_map.get (current_info);
+			// Weigh the least recently used entries by size and idle-time against their drawing-time
+			for (unowned SurfaceInfo? info = lru_tail; info != null && window < EVICTION_WINDOW; info = info.lru_prev) {
+				if (info.is_current)
+					continue;
 				
-				cache_mutex.unlock ();
+				window++;
 				
-				if (needs_scaling)
-					return surface.scaled_copy (width, height);
-				else
-					return surface;
+				var score = (double) (now - info.last_access_time + 1) * info.bytes / (info.drawing_time + 1);
+				if (victim == null || score > victim_score) {
+					victim = info;
+					victim_score = score;
+				}
 			}
 			
-			surface = draw_func (width, height, model, draw_data_func);
+			return victim;
+		}
+		
+		/**
+		 * Evicts surfaces until the budget is met, don't hold the lock of a store
+		 * while calling it.
+		 */
+		public void enforce ()
+		{
+			var victims = new Gee.ArrayList<SurfaceInfo> ();
+			var stores = new Gee.ArrayList<SurfaceStore> ();
+			var now = GLib.get_monotonic_time ();
 			
-			var finish_time = GLib.get_monotonic_time ();
-			var time_elapsed = finish_time - access_time;
+			mutex.lock ();
 			
-			// FIXME There is probably a nicer way to accomplish this
-			// Mark the created surface if drawing-time exceeded our limit and have
-			// an upper drawing-layer (e.g. DockRenderer) handle it
-			if (time_elapsed >= INSANE_DRAWING_TIME && flags == SurfaceCacheFlags.NONE) {
-				warning ("Creating surface took WAY TOO LONG (%" + int64.FORMAT + "ms), enabled downscaling for this cache!", time_elapsed / 1000);
-				flags = SurfaceCacheFlags.ALLOW_DOWNSCALE;
-				surface.set_qdata<string> (quark_surface_stats, SURFACE_STATS_DRAWING_TIME_EXCEEDED);
+			while (bytes > budget) {
+				unowned SurfaceInfo? victim = pick_victim (now);
+				if (victim == null)
+					break;
+				
+				// Linked entries still belong to their store, keep it alive until
+				// the entry is removed, even if its cache gets destroyed meanwhile
+				victims.add (victim);
+				stores.add (victim.store);
+				unlink (victim);
+				bytes -= victim.bytes;
+				entries--;
+				evictions++;
 			}
 			
-			current_info = new SurfaceInfo ((uint16) width, (uint16) height, finish_time, time_elapsed);
-			current_info.access_count++;
-			
-			cache_map.set (current_info, surface);
-			infos.add (current_info);
+			mutex.unlock ();
 			
-			cache_mutex.unlock ();
+			// Never hold our lock while acquiring the lock of a store
+			for (var i = 0; i < victims.size; i++)
+				stores[i].remove (victims[i]);
 			
-			return surface;
+			if (victims.size > 0)
+				Logger.verbose ("SurfaceCacheBudget.enforce (evicted %i, %" + int64.FORMAT + " bytes in use)", victims.size, bytes);
 		}
 		
-		unowned SurfaceInfo? find_match (uint16 width, uint16 height, out bool needs_scaling)
+		void schedule_clean_up ()
 		{
-			needs_scaling = false;
+			clean_up_timer_id = Gdk.threads_add_timeout_seconds (clean_up_interval, () => {
+				var rate = accesses_since_clean_up / clean_up_interval;
+				accesses_since_clean_up = 0;
+				
+				clean_up ();
+				
+				// Adapt the delay depending on the access rate
+				var interval = uint.max (MIN_CLEAN_UP_INTERVAL, MAX_CLEAN_UP_INTERVAL / (1 + rate / BUSY_ACCESS_RATE));
+				if (interval == clean_up_interval)
+					return true;
+				
+				clean_up_interval = interval;
+				schedule_clean_up ();
+				return false;
+			});
+		}
+		
+		void clean_up ()
+		{
+			var victims = new Gee.ArrayList<SurfaceInfo> ();
+			var stores = new Gee.ArrayList<SurfaceStore> ();
+			var now = GLib.get_monotonic_time ();
 			
-			if (infos.is_empty)
-				return null;
+			mutex.lock ();
 			
-			unowned SurfaceInfo? info;
-			// Check if the last requested entry matches already
-			if (last_info != null) {
-				info = last_info;
-				if (info.width == width && info.height == height)
-					return info;
+			var size_before = entries;
+			unowned SurfaceInfo? info = lru_tail;
+			while (info != null) {
+				unowned SurfaceInfo? prev = info.lru_prev;
 				
-				if ((flags & SurfaceCacheFlags.ALLOW_DOWNSCALE) != 0
-					&& info.width > width && info.height > height) {
-					needs_scaling = true;
-					return info;
+				if (!info.is_current
+					&& now - info.last_access_time >= ACCESS_REWARD * info.access_count
+					&& info.drawing_time <= MIN_DRAWING_TIME) {
+					victims.add (info);
+					stores.add (info.store);
+					unlink (info);
+					bytes -= info.bytes;
+					entries--;
 				}
 				
-				if ((flags & SurfaceCacheFlags.ALLOW_UPSCALE) != 0
-					&& info.width < width && info.height < height) {
-					needs_scaling = true;
-					return info;
-				}
+				info = prev;
 			}
 			
-			Gee.BidirIterator<unowned SurfaceInfo> infos_it;
-			if (last_info != null)
-				infos_it = (Gee.BidirIterator<unowned SurfaceInfo>) infos.iterator_at (last_info);
-			else
-				infos_it = infos.bidir_iterator ();
-			
-			if (last_info != null && last_info.compare_with (width, height) > 0) {
-				while (infos_it.previous ()) {
-					info = infos_it.get ();
-					
-					if (info.width == width && info.height == height)
-						return info;
-					
-					if ((flags & SurfaceCacheFlags.ALLOW_DOWNSCALE) != 0
-						&& info.width > width && info.height > height) {
-						needs_scaling = true;
-						return info;
-					}
-					
-					if ((flags & SurfaceCacheFlags.ALLOW_UPSCALE) != 0
-						&& info.width < width && info.height < height) {
-						needs_scaling = true;
-						return info;
-					}
-				}
-			} else {
-				while (infos_it.next ()) {
-					info = infos_it.get ();
-					
-					if (info.width == width && info.height == height)
-						return info;
-					
-					if ((flags & SurfaceCacheFlags.ALLOW_DOWNSCALE) != 0
-						&& info.width > width && info.height > height) {
-						needs_scaling = true;
-						return info;
-					}
-					
-					if ((flags & SurfaceCacheFlags.ALLOW_UPSCALE) != 0
-						&& info.width < width && info.height < height) {
-						needs_scaling = true;
-						return info;
-					}
-				}
-			}
+			mutex.unlock ();
 			
-			return null;
+			for (var i = 0; i < victims.size; i++)
+				stores[i].remove (victims[i]);
+			
+			Logger.verbose ("SurfaceCacheBudget.clean_up (%u -> %u, next in %us)", size_before, entries, clean_up_interval);
 		}
 		
-		public void clear ()
+		/**
+		 * Returns the current statistics, suitable to be sent over DBus.
+		 *
+		 * @return a dictionary of the statistics
+		 */
+		public HashTable<string, Variant> get_stats ()
 		{
-			cache_mutex.lock ();
+			var stats = new HashTable<string, Variant> (str_hash, str_equal);
 			
-			infos.clear ();
-			cache_map.clear ();
-			last_info = null;
+			mutex.lock ();
 			
-			cache_mutex.unlock ();
+			stats.insert ("hits", new Variant.uint64 (hits));
+			stats.insert ("scaled-hits", new Variant.uint64 (scaled_hits));
+			stats.insert ("misses", new Variant.uint64 (misses));
+			stats.insert ("evictions", new Variant.uint64 (evictions));
+			stats.insert ("entries", new Variant.uint32 (entries));
+			stats.insert ("bytes", new Variant.int64 (bytes));
+			stats.insert ("budget", new Variant.int64 (budget));
+			
+			mutex.unlock ();
+			
+			return stats;
+		}
+	}
+	
+	/**
+	 * Cache multiple sizes of the assumed same image
+	 *
+	 * The memory used by all caches is limited by a shared budget.
+	 */
+	public class SurfaceCache<G> : GLib.Object
+	{
+		const int64 INSANE_DRAWING_TIME = 30 * 1000;
+		const int64 ADAPTIVE_SCALE_DURATION = 5 * 1000 * 1000;
+		
+		public SurfaceCacheFlags flags { get; construct set; }
+		
+		SurfaceStore store;
+		int64 slow_drawing_time = 0;
+		
+		public SurfaceCache (SurfaceCacheFlags flags = SurfaceCacheFlags.NONE)
+		{
+			Object (flags: flags);
 		}
 		
-		void clean_up ()
+		construct
 		{
-			cache_mutex.lock ();
+			store = new SurfaceStore ();
+		}
+		
+		~SurfaceCache ()
+		{
+			store.clear (SurfaceCacheBudget.get_default ());
+		}
+		
+		public Surface? get_surface<G> (int width, int height, Surface model, DrawFunc<G> draw_func, DrawDataFunc<G>? draw_data_func)
+			requires (width >= 0 && height >= 0)
+		{
+			unowned SurfaceCacheBudget budget = SurfaceCacheBudget.get_default ();
+			var access_time = GLib.get_monotonic_time ();
 			
-			if (cache_map.size <= 1) {
-				cache_mutex.unlock ();
-				return;
-			}
+			store.mutex.lock ();
 			
-			var now = GLib.get_monotonic_time ();
-			var size_before = cache_map.size;
-			var size_current = size_before;
+			// Temporarily allow downscaling after drawing took too long,
+			// until then our consumer will request a large enough surface
+			var allow_downscale = (flags & SurfaceCacheFlags.ALLOW_DOWNSCALE) != 0
+				|| ((flags == SurfaceCacheFlags.NONE || (flags & SurfaceCacheFlags.ADAPTIVE_SCALE) != 0)
+				&& slow_drawing_time > 0 && access_time - slow_drawing_time < ADAPTIVE_SCALE_DURATION);
+			var allow_upscale = (flags & SurfaceCacheFlags.ALLOW_UPSCALE) != 0;
 			
-			var cache_it = cache_map.map_iterator ();
-			while (cache_it.next ()) {
-				var info = cache_it.get_key ();
+			bool needs_scaling;
+			var info = store.lookup ((uint16) width, (uint16) height, allow_downscale, allow_upscale, out needs_scaling);
+			
+			if (info != null) {
+				info.last_access_time = access_time;
+				info.access_count++;
+				store.set_current (info);
+				budget.touch (info, needs_scaling);
 				
-				if (now - info.last_access_time < ACCESS_REWARD * info.access_count)
-					continue;
+				var surface = info.surface;
 				
-				if (info.drawing_time > MIN_DRAWING_TIME)
-					continue;
+				store.mutex.unlock ();
 				
-				if (size_current <= 1)
-					break;
+				if (needs_scaling)
+					return surface.scaled_copy (width, height);
+				else
+					return surface;
+			}
+			
+			var surface = draw_func (width, height, model, draw_data_func);
+			if (surface == null) {
+				store.mutex.unlock ();
+				return null;
+			}
+			
+			// Placeholders are not cached, rather scale another available size
+			// until the real content is available
+			if (surface.get_qdata<string> (quark_surface_stats) == SURFACE_STATS_PLACEHOLDER) {
+				info = store.lookup ((uint16) width, (uint16) height, true, true, out needs_scaling);
+				Surface? fallback = (info != null ? info.surface : null);
+				
+				store.mutex.unlock ();
 				
-				infos.remove (info);
-				cache_it.unset ();
-				size_current--;
+				if (fallback != null)
+					return fallback.scaled_copy (width, height);
+				
+				return surface;
 			}
 			
-			last_info = null;
+			var finish_time = GLib.get_monotonic_time ();
+			var time_elapsed = finish_time - access_time;
+			
+			// FIXME There is probably a nicer way to accomplish this
+			// Mark the created surface if drawing-time exceeded our limit and have
+			// an upper drawing-layer (e.g. DockRenderer) handle it
+			if (time_elapsed >= INSANE_DRAWING_TIME && (flags & SurfaceCacheFlags.ALLOW_DOWNSCALE) == 0) {
+				if (slow_drawing_time == 0)
+					warning ("Creating surface took WAY TOO LONG (%" + int64.FORMAT + "ms), enabled adaptive downscaling for this cache!", time_elapsed / 1000);
+				slow_drawing_time = finish_time;
+				surface.set_qdata<string> (quark_surface_stats, SURFACE_STATS_DRAWING_TIME_EXCEEDED);
+			}
 			
-			Logger.verbose ("SurfaceCache.clean_up (%i -> %i) ", size_before, cache_map.size);
+			var new_info = new SurfaceInfo ((uint16) width, (uint16) height, surface, finish_time, time_elapsed);
+			new_info.access_count++;
+			store.add (new_info);
+			// Account it before a concurrent clear () may remove it again
+			budget.add (new_info);
 			
-			cache_mutex.unlock ();
+			store.mutex.unlock ();
+			
+			budget.enforce ();
+			
+			return surface;
+		}
+		
+		public void clear ()
+		{
+			store.clear (SurfaceCacheBudget.get_default ());
 		}
 	}
 }
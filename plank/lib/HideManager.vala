@@ -93,7 +93,6 @@ namespace Plank
 		uint hide_timer_id = 0U;
 		uint unhide_timer_id = 0U;
 		uint prefs_changed_timer_id = 0U;
-		uint geometry_timer_id = 0U;
 		uint window_changed_timer_id = 0U;
 		
 		bool pointer_update = true;
@@ -102,7 +101,7 @@ namespace Plank
 		bool active_application_intersect = false;
 		bool active_maximized_window_intersect = false;
 		bool dialog_windows_intersect = false;
-		Gdk.Rectangle last_window_rect;
+		WindowIntersectIndex window_index;
 		
 #if HAVE_BARRIERS
 		XFixes.PointerBarrier barrier = 0;
@@ -126,6 +125,8 @@ namespace Plank
 		construct
 		{
 			controller.prefs.notify.connect (prefs_changed);
+			
+			window_index = new WindowIntersectIndex ();
 		}
 		
 		/**
@@ -144,12 +145,12 @@ namespace Plank
 			window.enter_notify_event.connect (handle_enter_notify_event);
 			window.leave_notify_event.connect (handle_leave_notify_event);
 			
-			wnck_screen.window_opened.connect_after (schedule_update);
-			wnck_screen.window_closed.connect_after (schedule_update);
+			wnck_screen.window_opened.connect_after (handle_window_opened);
+			wnck_screen.window_closed.connect_after (handle_window_closed);
 			wnck_screen.active_window_changed.connect_after (handle_active_window_changed);
 			wnck_screen.active_workspace_changed.connect_after (handle_workspace_changed);
 			
-			setup_active_window (wnck_screen);
+			setup_windows (wnck_screen);
 		}
 		
 		~HideManager ()
@@ -163,11 +164,15 @@ namespace Plank
 			window.enter_notify_event.disconnect (handle_enter_notify_event);
 			window.leave_notify_event.disconnect (handle_leave_notify_event);
 			
-			wnck_screen.window_opened.disconnect (schedule_update);
-			wnck_screen.window_closed.disconnect (schedule_update);
+			wnck_screen.window_opened.disconnect (handle_window_opened);
+			wnck_screen.window_closed.disconnect (handle_window_closed);
 			wnck_screen.active_window_changed.disconnect (handle_active_window_changed);
 			wnck_screen.active_workspace_changed.disconnect (handle_workspace_changed);
 			
+			foreach (var w in wnck_screen.get_windows ())
+				untrack_window (w);
+			window_index.clear ();
+			
 			stop_timers ();
 			
 #if HAVE_BARRIERS
@@ -426,6 +431,216 @@ namespace Plank
 		// intelligent hiding code
 		//
 		
+		/**
+		 * Tracks which windows on the active workspace overlap the dock.
+		 *
+		 * Every window's contribution is cached, so a change of one window
+		 * only re-evaluates this window instead of walking all of them.
+		 */
+		class WindowIntersectIndex
+		{
+			class Entry
+			{
+				public unowned Wnck.Window window;
+				public int pid;
+				public bool intersects = false;
+				public bool is_dialog = false;
+				public bool is_maximized = false;
+				
+				public Entry (Wnck.Window _window)
+				{
+					window = _window;
+					pid = _window.get_pid ();
+				}
+			}
+			
+			Gee.HashMap<unowned Wnck.Window, Entry> entries;
+			Gee.HashMap<int, int> pid_intersect_counts;
+			Gee.HashMap<int, int> pid_dialog_counts;
+			int intersect_count = 0;
+			
+			Gdk.Rectangle dock_rect;
+			unowned Wnck.Workspace? workspace = null;
+			
+			public WindowIntersectIndex ()
+			{
+				entries = new Gee.HashMap<unowned Wnck.Window, Entry> ();
+				pid_intersect_counts = new Gee.HashMap<int, int> ();
+				pid_dialog_counts = new Gee.HashMap<int, int> ();
+				dock_rect = {};
+			}
+			
+			public void add (Wnck.Window window)
+			{
+				if (entries.has_key (window))
+					return;
+				
+				var entry = new Entry (window);
+				entries.set (window, entry);
+				evaluate (entry);
+			}
+			
+			public void remove (Wnck.Window window)
+			{
+				Entry entry;
+				if (!entries.unset (window, out entry))
+					return;
+				
+				set_intersects (entry, false);
+			}
+			
+			public void clear ()
+			{
+				entries.clear ();
+				pid_intersect_counts.clear ();
+				pid_dialog_counts.clear ();
+				intersect_count = 0;
+			}
+			
+			/**
+			 * Re-evaluates a single window, e.g. after its geometry or state changed.
+			 */
+			public void update (Wnck.Window window)
+			{
+				var entry = entries.get (window);
+				if (entry != null)
+					evaluate (entry);
+			}
+			
+			/**
+			 * Changes the area occupied by the dock, this re-evaluates all windows if it changed.
+			 */
+			public void set_dock_rect (Gdk.Rectangle rect)
+			{
+				if (rect.x == dock_rect.x && rect.y == dock_rect.y
+					&& rect.width == dock_rect.width && rect.height == dock_rect.height)
+					return;
+				
+				dock_rect = rect;
+				evaluate_all ();
+			}
+			
+			/**
+			 * Changes the active workspace, this re-evaluates all windows if it changed.
+			 */
+			public void set_workspace (Wnck.Workspace? _workspace)
+			{
+				if (workspace == _workspace)
+					return;
+				
+				workspace = _workspace;
+				evaluate_all ();
+			}
+			
+			public void query (Wnck.Window? active_window, out bool intersect, out bool dialog_intersect,
+				out bool active_intersect, out bool active_window_intersect, out bool active_maximized_intersect)
+			{
+				intersect = false;
+				dialog_intersect = false;
+				active_intersect = false;
+				active_window_intersect = false;
+				active_maximized_intersect = false;
+				
+				if (active_window == null || workspace == null)
+					return;
+				
+				var active_pid = active_window.get_pid ();
+				var active_entry = entries.get (active_window);
+				
+				intersect = (intersect_count > 0);
+				active_intersect = (pid_intersect_counts.get (active_pid) > 0);
+				dialog_intersect = (pid_dialog_counts.get (active_pid) > 0);
+				active_window_intersect = (active_entry != null && active_entry.intersects);
+				active_maximized_intersect = (active_window_intersect && active_entry.is_maximized);
+			}
+			
+			void evaluate_all ()
+			{
+				foreach (var entry in entries.values)
+					evaluate (entry);
+			}
+			
+			void evaluate (Entry entry)
+			{
+				unowned Wnck.Window w = entry.window;
+				
+				// Drop the old contribution first since the type might have changed
+				set_intersects (entry, false);
+				
+				entry.is_dialog = (w.get_window_type () == Wnck.WindowType.DIALOG);
+				entry.is_maximized = (w.is_maximized () || w.is_maximized_vertically () || w.is_maximized_horizontally ());
+				
+				set_intersects (entry, is_intersecting (w, entry.pid));
+			}
+			
+			bool is_intersecting (Wnck.Window w, int pid)
+			{
+				if (workspace == null || pid == plank_pid || w.is_minimized ())
+					return false;
+				
+				var type = w.get_window_type ();
+				if (type == Wnck.WindowType.DESKTOP || type == Wnck.WindowType.DOCK
+					|| type == Wnck.WindowType.MENU || type == Wnck.WindowType.SPLASHSCREEN)
+					return false;
+				
+				if (!w.is_visible_on_workspace (workspace))
+					return false;
+				
+				return window_geometry (w).intersect (dock_rect, null);
+			}
+			
+			void set_intersects (Entry entry, bool intersects)
+			{
+				if (entry.intersects == intersects)
+					return;
+				
+				entry.intersects = intersects;
+				
+				var delta = (intersects ? 1 : -1);
+				intersect_count += delta;
+				add_count (pid_intersect_counts, entry.pid, delta);
+				if (entry.is_dialog)
+					add_count (pid_dialog_counts, entry.pid, delta);
+			}
+			
+			static void add_count (Gee.HashMap<int, int> counts, int pid, int delta)
+			{
+				var count = counts.get (pid) + delta;
+				if (count > 0)
+					counts.set (pid, count);
+				else
+					counts.unset (pid);
+			}
+		}
+		
+		void setup_windows (Wnck.Screen screen)
+		{
+			window_index.set_workspace (screen.get_active_workspace ());
+			
+			foreach (var window in screen.get_windows ())
+				track_window (window);
+			
+			schedule_update ();
+		}
+		
+		void track_window (Wnck.Window window)
+		{
+			window.geometry_changed.connect_after (handle_window_changed);
+			window.workspace_changed.connect_after (handle_window_changed);
+			window.state_changed.connect_after (handle_state_changed);
+			
+			window_index.add (window);
+		}
+		
+		void untrack_window (Wnck.Window window)
+		{
+			window.geometry_changed.disconnect (handle_window_changed);
+			window.workspace_changed.disconnect (handle_window_changed);
+			window.state_changed.disconnect (handle_state_changed);
+			
+			window_index.remove (window);
+		}
+		
 		void update_window_intersect ()
 		{
 			var dock_rect = controller.position_manager.get_static_dock_region ();
@@ -437,56 +652,14 @@ namespace Plank
 				dock_rect.height *= window_scale_factor;
 			}
 			
-			var intersect = false;
-			var dialog_intersect = false;
-			var active_intersect = false;
-			var new_active_window_intersect = false;
-			var active_maximized_intersect = false;
 			unowned Wnck.Screen screen = Wnck.Screen.get_default ();
-			unowned Wnck.Window? active_window = screen.get_active_window ();
-			unowned Wnck.Workspace? active_workspace = screen.get_active_workspace ();
 			
-			if (active_window != null && active_workspace != null) {
-				var active_pid = active_window.get_pid ();
-				foreach (var w in screen.get_windows ()) {
-					if (w.is_minimized ())
-						continue;
-					var type = w.get_window_type ();
-					if (type == Wnck.WindowType.DESKTOP || type == Wnck.WindowType.DOCK
-						|| type == Wnck.WindowType.MENU || type == Wnck.WindowType.SPLASHSCREEN)
-						continue;
-					if (!w.is_visible_on_workspace (active_workspace))
-						continue;
-					var pid = w.get_pid ();
-					if (pid == plank_pid)
-						continue;
+			// Both only trigger a full re-evaluation if they actually changed
+			window_index.set_dock_rect (dock_rect);
+			window_index.set_workspace (screen.get_active_workspace ());
 					
-					if (window_geometry (w).intersect (dock_rect, null)) {
-						intersect = true;
-						
-						if (pid != active_pid)
-							continue;
-						
-						active_intersect = true;
-						
-						new_active_window_intersect = new_active_window_intersect || (active_window == w);
-						
-						active_maximized_intersect = active_maximized_intersect || (active_window == w
-							&& (w.is_maximized () || w.is_maximized_vertically () || w.is_maximized_horizontally ()));
-						
-						dialog_intersect = dialog_intersect || type == Wnck.WindowType.DIALOG;
-						
-						if (active_maximized_intersect && dialog_intersect)
-							break;
-					}
-				}
-			}
-			
-			window_intersect = intersect;
-			dialog_windows_intersect = dialog_intersect;
-			active_application_intersect = active_intersect;
-			active_window_intersect = new_active_window_intersect;
-			active_maximized_window_intersect = active_maximized_intersect;
+			window_index.query (screen.get_active_window (), out window_intersect, out dialog_windows_intersect,
+				out active_application_intersect, out active_window_intersect, out active_maximized_window_intersect);
 			
 			pointer_update = false;
 			update_hidden ();
@@ -505,61 +678,46 @@ namespace Plank
 		}
 		
 		[CCode (instance_pos = -1)]
-		void handle_workspace_changed (Wnck.Screen screen, Wnck.Workspace? previous)
+		void handle_window_opened (Wnck.Screen screen, Wnck.Window window)
 		{
+			track_window (window);
 			schedule_update ();
 		}
 		
 		[CCode (instance_pos = -1)]
-		void handle_active_window_changed (Wnck.Screen screen, Wnck.Window? previous)
+		void handle_window_closed (Wnck.Screen screen, Wnck.Window window)
 		{
-			if (previous != null) {
-				previous.geometry_changed.disconnect (handle_geometry_changed);
-				previous.state_changed.disconnect (handle_state_changed);
-			}
-			
-			setup_active_window (screen);
+			untrack_window (window);
+			schedule_update ();
 		}
 		
-		void setup_active_window (Wnck.Screen screen)
+		[CCode (instance_pos = -1)]
+		void handle_workspace_changed (Wnck.Screen screen, Wnck.Workspace? previous)
 		{
-			var active_window = screen.get_active_window ();
-			
-			if (active_window != null) {
-				last_window_rect = window_geometry (active_window);
-				active_window.geometry_changed.connect_after (handle_geometry_changed);
-				active_window.state_changed.connect_after (handle_state_changed);
-			}
-			
 			schedule_update ();
 		}
 		
 		[CCode (instance_pos = -1)]
-		void handle_state_changed (Wnck.Window window, Wnck.WindowState changed_mask, Wnck.WindowState new_state)
+		void handle_active_window_changed (Wnck.Screen screen, Wnck.Window? previous)
 		{
-			if ((changed_mask & Wnck.WindowState.MINIMIZED) == 0)
-				return;
-			
 			schedule_update ();
 		}
 		
 		[CCode (instance_pos = -1)]
-		void handle_geometry_changed (Wnck.Window window)
+		void handle_state_changed (Wnck.Window window, Wnck.WindowState changed_mask, Wnck.WindowState new_state)
 		{
-			var geo = window_geometry (window);
-			if (geo == last_window_rect)
+			if ((changed_mask & (Wnck.WindowState.MINIMIZED | Wnck.WindowState.MAXIMIZED_HORIZONTALLY
+				| Wnck.WindowState.MAXIMIZED_VERTICALLY)) == 0)
 				return;
 			
-			last_window_rect = geo;
-			
-			if (geometry_timer_id > 0U)
-				return;
-			
-			geometry_timer_id = Gdk.threads_add_timeout (UPDATE_TIMEOUT, () => {
-				update_window_intersect ();
-				geometry_timer_id = 0U;
-				return false;
-			});
+			handle_window_changed (window);
+		}
+		
+		[CCode (instance_pos = -1)]
+		void handle_window_changed (Wnck.Window window)
+		{
+			window_index.update (window);
+			schedule_update ();
 		}
 		
 		static Gdk.Rectangle window_geometry (Wnck.Window window)
@@ -571,11 +729,6 @@ namespace Plank
 		
 		void stop_timers ()
 		{
-			if (geometry_timer_id > 0U) {
-				GLib.Source.remove (geometry_timer_id);
-				geometry_timer_id = 0U;
-			}
-			
 			if (window_changed_timer_id > 0U) {
 				GLib.Source.remove (window_changed_timer_id);
 				window_changed_timer_id = 0U;
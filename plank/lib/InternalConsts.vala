@@ -35,6 +35,7 @@ namespace Plank
 	public const string DOCKLET_URI_PREFIX = "docklet://";
 	
 	public const string SURFACE_STATS_DRAWING_TIME_EXCEEDED = "drawing-time-exceeded";
+	public const string SURFACE_STATS_PLACEHOLDER = "placeholder";
 	
 	public const uint FOLDER_MAX_FILE_COUNT = 192;
 	public const uint LAUNCHER_DIR_MAX_FILE_COUNT = 128;
@@ -123,6 +123,8 @@ namespace Plank
 		SurfaceCache<DockItem> buffer;
 		SurfaceCache<DockItem> background_buffer;
 		Surface? foreground_surface = null;
+		Color loaded_icon_color;
+		bool has_loaded_icon_color = false;
 		
 		FileMonitor? launcher_file_monitor = null;
 		FileMonitor? icon_file_monitor = null;
@@ -277,6 +279,7 @@ namespace Plank
 		{
 			switch (event) {
 			case FileMonitorEvent.CHANGES_DONE_HINT:
+				IconLoader.get_default ().invalidate (Icon);
 				reset_icon_buffer ();
 				break;
 			default:
@@ -446,13 +449,28 @@ namespace Plank
 			var surface = new Surface.with_surface (width, height, model);
 			
 			Logger.verbose ("DockItem.draw_icon (width = %i, height = %i)", width, height);
+			has_loaded_icon_color = false;
 			draw_icon (surface);
 			
-			AverageIconColor = surface.average_color ();
+			if (has_loaded_icon_color)
+				AverageIconColor = loaded_icon_color;
+			else if (surface.get_qdata<string> (quark_surface_stats) != SURFACE_STATS_PLACEHOLDER)
+				AverageIconColor = surface.average_color ();
 			
 			return surface;
 		}
 		
+		/**
+		 * Called once an icon requested by draw_icon () finished loading.
+		 */
+		internal void icon_loaded ()
+		{
+			// Shadows might be based on the placeholder
+			background_buffer.clear ();
+			
+			needs_redraw ();
+		}
+		
 		/**
 		 * Returns the background surface for this item.
 		 *
@@ -524,33 +542,37 @@ namespace Plank
 		/**
 		 * Draws the item's icon onto a surface.
 		 *
+		 * The icon is loaded in the background, a placeholder is drawn
+		 * until it is available.
+		 *
 		 * @param surface the surface to draw on
 		 */
 		protected virtual void draw_icon (Surface surface)
 		{
-			Cairo.Surface? icon = null;
-			Gdk.Pixbuf? pbuf = ForcePixbuf;
-			if (pbuf == null) {
-				double x_scale = 1.0, y_scale = 1.0;
-				surface.Internal.get_device_scale (out x_scale, out y_scale);
-				icon = DrawingService.load_icon_for_scale (Icon, surface.Width, surface.Height, (int) double.max (x_scale, y_scale));
-				if (icon != null)
-					icon.set_device_scale (1.0, 1.0);
-			} else {
-				pbuf = DrawingService.ar_scale (pbuf, surface.Width, surface.Height);
+			double x_scale = 1.0, y_scale = 1.0;
+			surface.Internal.get_device_scale (out x_scale, out y_scale);
+			var scale = (int) double.max (x_scale, y_scale);
+			
+			// Only persist the resting size, zoomed sizes change with every animation step
+			unowned DockController? controller = get_dock ();
+			var persist = (controller != null && surface.Width == controller.position_manager.IconSize * scale);
+			
+			Color color;
+			var icon = IconLoader.get_default ().get_icon (this, Icon, ForcePixbuf, surface.Width, surface.Height, scale, persist, out color);
+			
+			if (icon == null) {
+				draw_icon_fast (surface);
+				surface.set_qdata<string> (quark_surface_stats, SURFACE_STATS_PLACEHOLDER);
+				return;
 			}
 			
 			unowned Cairo.Context cr = surface.Context;
+			cr.set_source_surface (icon, 0, 0);
+			cr.paint ();
 			
-			if (pbuf != null) {
-				Gdk.cairo_set_source_pixbuf (cr, pbuf, (surface.Width - pbuf.width) / 2, (surface.Height - pbuf.height) / 2);
-				cr.paint ();
-			} else if (icon != null) {
-				cr.set_source_surface (icon, 0, 0);
-				cr.paint ();
-			} else {
-				warn_if_reached ();
-			}
+			// the loader already knows the average color of the plain icon
+			loaded_icon_color = color;
+			has_loaded_icon_color = true;
 		}
 		
 		/**
@@ -42,7 +42,14 @@ namespace Plank
 		[Description(nick = "show-notifications")]
 		public bool ShowNotifications { get; private set; default = true; }
 		
+		/**
+		 * Whether the system is running on battery power
+		 */
+		[Description(nick = "on-battery")]
+		public bool OnBattery { get; private set; default = false; }
+		
 		DesktopNofications? notifications;
+		DBusProxy? upower = null;
 		
 		EnvironmentSettings ()
 		{
@@ -67,12 +74,37 @@ namespace Plank
 				notifications_changed ();
 				notifications.notify.connect (notifications_changed);
 			}
+			
+			watch_upower.begin ();
 		}
 		
 		~EnvironmentSettings ()
 		{
 			if (notifications != null)
 				notifications.notify.disconnect (notifications_changed);
+			
+			if (upower != null)
+				upower.g_properties_changed.disconnect (upower_properties_changed);
+		}
+		
+		async void watch_upower ()
+		{
+			try {
+				upower = yield new DBusProxy.for_bus (BusType.SYSTEM, DBusProxyFlags.DO_NOT_AUTO_START, null,
+					"org.freedesktop.UPower", "/org/freedesktop/UPower", "org.freedesktop.UPower");
+			} catch (Error e) {
+				debug ("UPower not available (%s)", e.message);
+				return;
+			}
+			
+			upower.g_properties_changed.connect (upower_properties_changed);
+			upower_properties_changed ();
+		}
+		
+		void upower_properties_changed ()
+		{
+			var on_battery = upower.get_cached_property ("OnBattery");
+			OnBattery = (on_battery != null && on_battery.is_of_type (VariantType.BOOLEAN) && on_battery.get_boolean ());
 		}
 		
 		void notifications_changed ()
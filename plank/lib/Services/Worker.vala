@@ -32,11 +32,15 @@ namespace Plank
 	{
 		public ThreadFunc<void*> func;
 		public TaskPriority priority;
+		public Cancellable? cancellable;
+		public int64 queue_time;
 		
-		public Task (owned ThreadFunc<void*> _func, TaskPriority _priority)
+		public Task (owned ThreadFunc<void*> _func, TaskPriority _priority, Cancellable? _cancellable)
 		{
 			func = _func;
 			priority = _priority;
+			cancellable = _cancellable;
+			queue_time = GLib.get_monotonic_time ();
 		}
 		
 		public void* run ()
@@ -45,8 +49,68 @@ namespace Plank
 		}
 	}
 	
+	[Compact]
+	class TaskCompletion
+	{
+		public SourceFunc func;
+		
+		public TaskCompletion (owned SourceFunc _func)
+		{
+			func = (owned) _func;
+		}
+	}
+	
+	/**
+	 * The queues of one thread of the {@link Worker}, one per {@link TaskPriority}.
+	 *
+	 * The owning thread takes its newest tasks first, other threads steal
+	 * the oldest ones.
+	 */
+	[Compact]
+	class WorkerQueue
+	{
+		public Mutex mutex;
+		public Queue<Task>[] lanes;
+		
+		public WorkerQueue ()
+		{
+			lanes = { new Queue<Task> (), new Queue<Task> (), new Queue<Task> () };
+		}
+		
+		public void push (owned Task task)
+		{
+			mutex.lock ();
+			lanes[task.priority].push_tail ((owned) task);
+			mutex.unlock ();
+		}
+		
+		public Task? pop (TaskPriority priority, bool steal)
+		{
+			mutex.lock ();
+			unowned Queue<Task> lane = lanes[priority];
+			Task? task = null;
+			if (!lane.is_empty ())
+				task = (steal ? lane.pop_head () : lane.pop_tail ());
+			mutex.unlock ();
+			
+			return task;
+		}
+	}
+	
+	/**
+	 * Runs tasks on a fixed set of threads, one per processor.
+	 *
+	 * The threads are kept alive for the lifetime of the process.  Tasks
+	 * added from one of these threads are queued locally, idle threads
+	 * steal from busy ones.  Higher priorities are always drained first.
+	 *
+	 * Results of {@link Worker.add_task_with_result} are handed back to the
+	 * main-loop in batches through one idle with GLib.Priority.HIGH_IDLE.
+	 */
 	public class Worker : Object
 	{
+		const double AVERAGE_WEIGHT = 0.125;
+		
 		static Worker? worker = null;
 		
 		public static unowned Worker get_default ()
@@ -56,7 +120,30 @@ namespace Plank
 			return worker;
 		}
 		
-		ThreadPool<Task> pool;
+		static Private current_queue = new Private ();
+		
+		WorkerQueue[] queues;
+		Thread<void*>[] threads;
+		uint next_queue = 0U;
+		
+		Mutex idle_mutex;
+		Cond idle_cond;
+		int pending = 0;
+		int idle_threads = 0;
+		
+		Mutex completion_mutex;
+		Queue<TaskCompletion> completions;
+		uint completion_idle_id = 0U;
+		
+		Mutex stats_mutex;
+		int pending_per_priority[3];
+		uint64 completed_tasks = 0ULL;
+		uint64 cancelled_tasks = 0ULL;
+		uint64 stolen_tasks = 0ULL;
+		uint64 completion_batches = 0ULL;
+		double average_wait_time = 0.0;
+		double average_run_time = 0.0;
+		int64 max_wait_time = 0LL;
 		
 		private Worker ()
 		{
@@ -64,49 +151,149 @@ namespace Plank
 		
 		construct
 		{
-			try {
-				ThreadPool.set_max_unused_threads (0);
-				
-				var thread_count = (int) GLib.get_num_processors ();
-				message ("Using up to %i threads.", thread_count);
+			var thread_count = (int) GLib.get_num_processors ();
+			message ("Using %i threads.", thread_count);
+			
+			completions = new Queue<TaskCompletion> ();
+			
+			queues = new WorkerQueue[thread_count];
+			for (var i = 0; i < thread_count; i++)
+				queues[i] = new WorkerQueue ();
+			
+			threads = new Thread<void*>[thread_count];
+			for (var i = 0; i < thread_count; i++) {
+				var index = i;
+				try {
+					threads[i] = new Thread<void*>.try ("plank-worker-%i".printf (index), () => {
+						return run_thread (index);
+					});
+				} catch (Error e) {
+					error ("Creating worker thread failed! (%s)", e.message);
+				}
+			}
+		}
+		
+		void* run_thread (int index)
+		{
+			current_queue.set (queues[index]);
+			
+			while (true) {
+				var task = find_task (index);
+				if (task == null) {
+					idle_mutex.lock ();
+					idle_threads++;
+					while (AtomicInt.get (ref pending) <= 0)
+						idle_cond.wait (idle_mutex);
+					idle_threads--;
+					idle_mutex.unlock ();
+					continue;
+				}
 				
-				pool = new ThreadPool<Task>.with_owned_data ((task) => {
-					task.run ();
-				}, thread_count, false);
+				AtomicInt.add (ref pending, -1);
+				run_task ((owned) task);
+			}
+		}
+		
+		Task? find_task (int index)
+		{
+			for (int p = TaskPriority.HIGH; p >= TaskPriority.LOW; p--) {
+				var priority = (TaskPriority) p;
+				var task = queues[index].pop (priority, false);
+				if (task != null)
+					return task;
 				
-				pool.set_sort_function ((CompareDataFunc) compare_task_priority);
-			} catch (ThreadError e) {
-				error ("Creating ThreadPool failed! (%s)", e.message);
+				for (var i = 1; i < queues.length; i++) {
+					task = queues[(index + i) % queues.length].pop (priority, true);
+					if (task != null) {
+						stats_mutex.lock ();
+						stolen_tasks++;
+						stats_mutex.unlock ();
+						return task;
+					}
+				}
 			}
+			
+			return null;
+		}
+		
+		void run_task (owned Task task)
+		{
+			var start = GLib.get_monotonic_time ();
+			var cancelled = (task.cancellable != null && task.cancellable.is_cancelled ());
+			
+			// Cancelled tasks skip their work themselves, but might still need to resume their caller
+			task.run ();
+			
+			var end = GLib.get_monotonic_time ();
+			var wait_time = start - task.queue_time;
+			
+			stats_mutex.lock ();
+			pending_per_priority[task.priority]--;
+			if (cancelled)
+				cancelled_tasks++;
+			else
+				completed_tasks++;
+			average_wait_time += (wait_time - average_wait_time) * AVERAGE_WEIGHT;
+			average_run_time += ((end - start) - average_run_time) * AVERAGE_WEIGHT;
+			max_wait_time = int64.max (max_wait_time, wait_time);
+			stats_mutex.unlock ();
 		}
 		
-		static int compare_task_priority (Task t1, Task t2)
+		void push_task (owned Task task)
 		{
-			int p1 = t1.priority, p2 = t2.priority;
-			return (p1 < p2 ? -1 : (int) (p1 > p2));
+			stats_mutex.lock ();
+			pending_per_priority[task.priority]++;
+			stats_mutex.unlock ();
+			
+			// Tasks spawned by a worker thread stay on its own queue
+			unowned WorkerQueue? queue = (WorkerQueue?) current_queue.get ();
+			if (queue == null) {
+				var index = AtomicUint.add (ref next_queue, 1U) % queues.length;
+				queue = queues[index];
+			}
+			queue.push ((owned) task);
+			
+			AtomicInt.add (ref pending, 1);
+			
+			idle_mutex.lock ();
+			if (idle_threads > 0)
+				idle_cond.signal ();
+			idle_mutex.unlock ();
 		}
 		
 		/**
-		 * Schedule given function to be run in our ThreadPool
-		 * The given priority influences execution-time of the task 
-		 * depending on the currently scheduled amount of tasks.
+		 * Schedule given function to be run on one of our threads.
+		 * Tasks with a higher priority are run first.
 		 *
 		 * @param func function to be executed
 		 * @param priority priority of the given function
 		 */
 		public void add_task (owned ThreadFunc<void*> func, TaskPriority priority = TaskPriority.DEFAULT)
 		{
-			try {
-				pool.add (new Task (func, priority));
-			} catch (ThreadError e) {
-				warning (e.message);
-			}
+			push_task (new Task ((owned) func, priority, null));
 		}
 		
 		/**
-		 * Schedule given function to be run in our ThreadPool
-		 * The given priority influences execution-time of the task 
-		 * depending on the currently scheduled amount of tasks.
+		 * Schedule given function to be run on one of our threads.
+		 * Tasks with a higher priority are run first.
+		 *
+		 * @param func function to be executed
+		 * @param priority priority of the given function
+		 * @param cancellable if cancelled before the task started it won't be run
+		 */
+		public void add_cancellable_task (owned ThreadFunc<void*> func, TaskPriority priority = TaskPriority.DEFAULT, Cancellable? cancellable = null)
+		{
+			ThreadFunc<void*> tfunc = () => {
+				if (cancellable == null || !cancellable.is_cancelled ())
+					func ();
+				return null;
+			};
+			push_task (new Task ((owned) tfunc, priority, cancellable));
+		}
+		
+		/**
+		 * Schedule given function to be run on one of our threads.
+		 * Tasks with a higher priority are run first.
 		 *
 		 * AsyncReadyCallback will be executed on the main-thread through an idle
 		 * with GLib.Priority.HIGH_IDLE.
@@ -117,31 +304,102 @@ namespace Plank
 		 */
 		public async G add_task_with_result<G> (owned TaskFunc<G> func, TaskPriority priority = TaskPriority.DEFAULT) throws Error
 		{
-			SourceFunc resume = add_task_with_result.callback;
+			return yield add_cancellable_task_with_result<G> ((owned) func, priority, null);
+		}
+		
+		/**
+		 * Schedule given function to be run on one of our threads.
+		 * Tasks with a higher priority are run first.
+		 *
+		 * AsyncReadyCallback will be executed on the main-thread through an idle
+		 * with GLib.Priority.HIGH_IDLE.
+		 *
+		 * @param func the function to be executed returning a typed result
+		 * @param priority priority of the given function
+		 * @param cancellable if cancelled before the task finished IOError.CANCELLED is thrown
+		 * @return the typed result
+		 */
+		public async G add_cancellable_task_with_result<G> (owned TaskFunc<G> func, TaskPriority priority = TaskPriority.DEFAULT, Cancellable? cancellable = null) throws Error
+		{
+			SourceFunc resume = add_cancellable_task_with_result.callback;
 			Error err = null;
 			G result = null;
 			
-			try {
-				ThreadFunc tfunc = () => {
-					try {
-						result = func ();
-					} catch (Error e) {
-						err = e;
-					}
-					
-					Idle.add ((owned) resume, GLib.Priority.HIGH_IDLE);
-					return null;
-				};
-				pool.add (new Task (tfunc, priority));
-			} catch (ThreadError e) {
-				warning (e.message);
-			}
+			ThreadFunc<void*> tfunc = () => {
+				try {
+					if (cancellable != null)
+						cancellable.set_error_if_cancelled ();
+					result = func ();
+				} catch (Error e) {
+					err = e;
+				}
+				
+				complete ((owned) resume);
+				return null;
+			};
+			push_task (new Task ((owned) tfunc, priority, cancellable));
 			
 			yield;
+			if (err == null && cancellable != null)
+				cancellable.set_error_if_cancelled ();
 			if (err != null)
 				throw err;
 			
 			return result;
 		}
+		
+		void complete (owned SourceFunc resume)
+		{
+			completion_mutex.lock ();
+			completions.push_tail (new TaskCompletion ((owned) resume));
+			if (completion_idle_id == 0U)
+				completion_idle_id = Idle.add (dispatch_completions, GLib.Priority.HIGH_IDLE);
+			completion_mutex.unlock ();
+		}
+		
+		bool dispatch_completions ()
+		{
+			completion_mutex.lock ();
+			var batch = (owned) completions;
+			completions = new Queue<TaskCompletion> ();
+			completion_idle_id = 0U;
+			completion_mutex.unlock ();
+			
+			stats_mutex.lock ();
+			completion_batches++;
+			stats_mutex.unlock ();
+			
+			TaskCompletion? completion;
+			while ((completion = batch.pop_head ()) != null)
+				completion.func ();
+			
+			return false;
+		}
+		
+		/**
+		 * Returns the counters of the scheduled tasks, times are given in microseconds.
+		 *
+		 * @return a dictionary of the counters
+		 */
+		public HashTable<string, Variant> get_stats ()
+		{
+			var stats = new HashTable<string, Variant> (str_hash, str_equal);
+			
+			stats_mutex.lock ();
+			stats.insert ("threads", new Variant.int32 (threads.length));
+			stats.insert ("queued-low", new Variant.int32 (pending_per_priority[TaskPriority.LOW]));
+			stats.insert ("queued-default", new Variant.int32 (pending_per_priority[TaskPriority.DEFAULT]));
+			stats.insert ("queued-high", new Variant.int32 (pending_per_priority[TaskPriority.HIGH]));
+			stats.insert ("completed", new Variant.uint64 (completed_tasks));
+			stats.insert ("cancelled", new Variant.uint64 (cancelled_tasks));
+			stats.insert ("stolen", new Variant.uint64 (stolen_tasks));
+			stats.insert ("completion-batches", new Variant.uint64 (completion_batches));
+			stats.insert ("average-wait-time", new Variant.double (average_wait_time));
+			stats.insert ("average-run-time", new Variant.double (average_run_time));
+			stats.insert ("max-wait-time", new Variant.int64 (max_wait_time));
+			stats_mutex.unlock ();
+			
+			return stats;
+		}
 	}
 }
@@ -0,0 +1,269 @@
+/*
+ *  Copyright (C) 2011-2012 Robert Dyer, Rico Tzschichholz
+ *  Copyright (C) 2026 The Plank Developers
+ *
+ *  This file is part of Plank.
+ *
+ *  Plank is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Plank is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "blur-kernels.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define HAVE_BLUR_SSE2 1
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+	&& (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9) || defined(__clang__))
+#include <immintrin.h>
+#define HAVE_BLUR_AVX2 1
+#endif
+
+/*
+ * All box kernels keep their running sums as 16bit fixed-point values.
+ * A sum never exceeds 255 * (2 * PLANK_BLUR_MAX_BOX_RADIUS + 1) < 65536,
+ * and the division by the box width is replaced by a multiplication with
+ * its rounded-up reciprocal in 0.16 fixed-point, followed by a shift.
+ */
+
+typedef void (*BoxVerticalStepFunc) (guint16 *sums, guint8 *dest, const guint8 *add, const guint8 *sub, gint n, guint16 mul);
+
+static inline guint16
+box_reciprocal (gint div)
+{
+	return (guint16) ((65536 + div - 1) / div);
+}
+
+void
+plank_blur_box_horizontal (guint8 *pixels, gint stride, gint width, gint row_start, gint row_end, gint radius)
+{
+	guint8 *line;
+	guint32 mul;
+	gint y;
+
+	if (radius < 1 || width < 1 || row_start >= row_end)
+		return;
+
+	radius = MIN (radius, PLANK_BLUR_MAX_BOX_RADIUS);
+	mul = box_reciprocal (2 * radius + 1);
+	line = g_malloc (width * 4);
+
+	for (y = row_start; y < row_end; y++) {
+		guint8 *row = pixels + y * stride;
+		guint32 s0, s1, s2, s3;
+		gint i, x;
+
+		memcpy (line, row, width * 4);
+
+		s0 = (radius + 1) * line[0];
+		s1 = (radius + 1) * line[1];
+		s2 = (radius + 1) * line[2];
+		s3 = (radius + 1) * line[3];
+
+		for (i = 1; i <= radius; i++) {
+			gint p = MIN (i, width - 1) * 4;
+			s0 += line[p + 0];
+			s1 += line[p + 1];
+			s2 += line[p + 2];
+			s3 += line[p + 3];
+		}
+
+		for (x = 0; x < width; x++) {
+			gint p1 = MIN (x + radius + 1, width - 1) * 4;
+			gint p2 = MAX (x - radius, 0) * 4;
+
+			row[x * 4 + 0] = (guint8) ((s0 * mul) >> 16);
+			row[x * 4 + 1] = (guint8) ((s1 * mul) >> 16);
+			row[x * 4 + 2] = (guint8) ((s2 * mul) >> 16);
+			row[x * 4 + 3] = (guint8) ((s3 * mul) >> 16);
+
+			s0 += line[p1 + 0] - line[p2 + 0];
+			s1 += line[p1 + 1] - line[p2 + 1];
+			s2 += line[p1 + 2] - line[p2 + 2];
+			s3 += line[p1 + 3] - line[p2 + 3];
+		}
+	}
+
+	g_free (line);
+}
+
+static void
+box_vertical_step_c (guint16 *sums, guint8 *dest, const guint8 *add, const guint8 *sub, gint n, guint16 mul)
+{
+	gint i;
+
+	for (i = 0; i < n; i++) {
+		dest[i] = (guint8) (((guint32) sums[i] * mul) >> 16);
+		sums[i] = (guint16) (sums[i] + add[i] - sub[i]);
+	}
+}
+
+#ifdef HAVE_BLUR_SSE2
+static void
+box_vertical_step_sse2 (guint16 *sums, guint8 *dest, const guint8 *add, const guint8 *sub, gint n, guint16 mul)
+{
+	const __m128i zero = _mm_setzero_si128 ();
+	const __m128i vmul = _mm_set1_epi16 ((short) mul);
+	gint i = 0;
+
+	for (; i + 16 <= n; i += 16) {
+		__m128i lo = _mm_loadu_si128 ((const __m128i *) (sums + i));
+		__m128i hi = _mm_loadu_si128 ((const __m128i *) (sums + i + 8));
+		__m128i a = _mm_loadu_si128 ((const __m128i *) (add + i));
+		__m128i s = _mm_loadu_si128 ((const __m128i *) (sub + i));
+
+		_mm_storeu_si128 ((__m128i *) (dest + i),
+			_mm_packus_epi16 (_mm_mulhi_epu16 (lo, vmul), _mm_mulhi_epu16 (hi, vmul)));
+
+		lo = _mm_sub_epi16 (_mm_add_epi16 (lo, _mm_unpacklo_epi8 (a, zero)), _mm_unpacklo_epi8 (s, zero));
+		hi = _mm_sub_epi16 (_mm_add_epi16 (hi, _mm_unpackhi_epi8 (a, zero)), _mm_unpackhi_epi8 (s, zero));
+
+		_mm_storeu_si128 ((__m128i *) (sums + i), lo);
+		_mm_storeu_si128 ((__m128i *) (sums + i + 8), hi);
+	}
+
+	box_vertical_step_c (sums + i, dest + i, add + i, sub + i, n - i, mul);
+}
+#endif
+
+#ifdef HAVE_BLUR_AVX2
+__attribute__((target ("avx2")))
+static void
+box_vertical_step_avx2 (guint16 *sums, guint8 *dest, const guint8 *add, const guint8 *sub, gint n, guint16 mul)
+{
+	const __m256i vmul = _mm256_set1_epi16 ((short) mul);
+	gint i = 0;
+
+	for (; i + 32 <= n; i += 32) {
+		__m256i lo = _mm256_loadu_si256 ((const __m256i *) (sums + i));
+		__m256i hi = _mm256_loadu_si256 ((const __m256i *) (sums + i + 16));
+		__m256i a_lo = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (add + i)));
+		__m256i a_hi = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (add + i + 16)));
+		__m256i s_lo = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (sub + i)));
+		__m256i s_hi = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (sub + i + 16)));
+		__m256i packed;
+
+		/* packus works per 128bit lane, restore the linear byte order afterwards */
+		packed = _mm256_packus_epi16 (_mm256_mulhi_epu16 (lo, vmul), _mm256_mulhi_epu16 (hi, vmul));
+		_mm256_storeu_si256 ((__m256i *) (dest + i), _mm256_permute4x64_epi64 (packed, 0xD8));
+
+		lo = _mm256_sub_epi16 (_mm256_add_epi16 (lo, a_lo), s_lo);
+		hi = _mm256_sub_epi16 (_mm256_add_epi16 (hi, a_hi), s_hi);
+
+		_mm256_storeu_si256 ((__m256i *) (sums + i), lo);
+		_mm256_storeu_si256 ((__m256i *) (sums + i + 16), hi);
+	}
+
+#ifdef HAVE_BLUR_SSE2
+	box_vertical_step_sse2 (sums + i, dest + i, add + i, sub + i, n - i, mul);
+#else
+	box_vertical_step_c (sums + i, dest + i, add + i, sub + i, n - i, mul);
+#endif
+}
+#endif
+
+static BoxVerticalStepFunc box_vertical_step = NULL;
+static const gchar *box_vertical_step_name = NULL;
+
+static void
+box_vertical_step_init (void)
+{
+	static gsize initialized = 0;
+
+	if (!g_once_init_enter (&initialized))
+		return;
+
+	box_vertical_step = box_vertical_step_c;
+	box_vertical_step_name = "c";
+
+#ifdef HAVE_BLUR_SSE2
+	box_vertical_step = box_vertical_step_sse2;
+	box_vertical_step_name = "sse2";
+#endif
+
+#ifdef HAVE_BLUR_AVX2
+	__builtin_cpu_init ();
+	if (__builtin_cpu_supports ("avx2")) {
+		box_vertical_step = box_vertical_step_avx2;
+		box_vertical_step_name = "avx2";
+	}
+#endif
+
+	g_once_init_leave (&initialized, 1);
+}
+
+void
+plank_blur_box_vertical (guint8 *pixels, gint stride, gint height, gint col_start, gint col_end, gint radius)
+{
+	guint8 *base, *ring;
+	guint16 *sums;
+	guint16 mul;
+	gint div, n, i, y;
+
+	if (radius < 1 || height < 1 || col_start >= col_end)
+		return;
+
+	box_vertical_step_init ();
+
+	radius = MIN (radius, PLANK_BLUR_MAX_BOX_RADIUS);
+	div = 2 * radius + 1;
+	mul = box_reciprocal (div);
+
+	base = pixels + col_start * 4;
+	n = (col_end - col_start) * 4;
+
+	/* The last div source rows of this strip, needed once they were overwritten */
+	ring = g_malloc (div * n);
+	sums = g_new (guint16, n);
+
+	for (i = 0; i < n; i++)
+		sums[i] = (guint16) ((radius + 1) * base[i]);
+
+	for (y = 1; y <= radius; y++) {
+		const guint8 *row = base + MIN (y, height - 1) * stride;
+		for (i = 0; i < n; i++)
+			sums[i] += row[i];
+	}
+
+	for (y = 0; y < height; y++) {
+		guint8 *dest = base + y * stride;
+		guint8 *saved = ring + (y % div) * n;
+
+		memcpy (saved, dest, n);
+
+		if (y == height - 1) {
+			box_vertical_step (sums, dest, saved, saved, n, mul);
+			break;
+		}
+
+		box_vertical_step (sums, dest,
+			base + MIN (y + radius + 1, height - 1) * stride,
+			ring + (MAX (y - radius, 0) % div) * n,
+			n, mul);
+	}
+
+	g_free (sums);
+	g_free (ring);
+}
+
+const gchar *
+plank_blur_get_kernel_name (void)
+{
+	box_vertical_step_init ();
+
+	return box_vertical_step_name;
+}
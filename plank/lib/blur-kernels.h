@@ -0,0 +1,47 @@
+/*
+ *  Copyright (C) 2011-2012 Robert Dyer, Rico Tzschichholz
+ *  Copyright (C) 2026 The Plank Developers
+ *
+ *  This file is part of Plank.
+ *
+ *  Plank is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Plank is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PLANK_BLUR_KERNELS_H__
+#define __PLANK_BLUR_KERNELS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Largest radius the 16-bit fixed-point box kernels can handle without overflow */
+#define PLANK_BLUR_MAX_BOX_RADIUS 127
+
+/*
+ * Box blur kernels working in-place on 32bit pixels (e.g. CAIRO_FORMAT_ARGB32).
+ * Pixels outside of the image are clamped to the nearest edge pixel.
+ *
+ * The horizontal kernel blurs the rows [row_start, row_end), the vertical kernel
+ * blurs the columns [col_start, col_end) over the full height of the image.
+ * Distinct row/column ranges may be processed concurrently.
+ */
+void plank_blur_box_horizontal (guint8 *pixels, gint stride, gint width, gint row_start, gint row_end, gint radius);
+void plank_blur_box_vertical (guint8 *pixels, gint stride, gint height, gint col_start, gint col_end, gint radius);
+
+/* Name of the vertical kernel implementation picked for this cpu, e.g. "avx2" */
+const gchar *plank_blur_get_kernel_name (void);
+
+G_END_DECLS
+
+#endif
@@ -35,8 +35,12 @@ namespace PlankTests
 		Test.add_func ("/Drawing/Surface/exponential_blur", drawing_docksurface_exponential_blur);
 		Test.add_func ("/Drawing/Surface/fast_blur", drawing_docksurface_fast_blur);
 		Test.add_func ("/Drawing/Surface/gaussian_blur", drawing_docksurface_gaussian_blur);
+		Test.add_func ("/Drawing/Surface/blur_uniform", drawing_docksurface_blur_uniform);
 		Test.add_func ("/Drawing/Surface/to_pixbuf", drawing_docksurface_to_pixbuf);
 		
+		Test.add_func ("/Drawing/SurfaceCache/basics", drawing_surfacecache);
+		Test.add_func ("/Drawing/SurfaceCache/budget", drawing_surfacecache_budget);
+		
 		Test.add_func ("/Drawing/Easing/basics", drawing_easing);
 		
 		Test.add_func ("/Drawing/Theme/basics", drawing_theme);
@@ -394,6 +398,28 @@ namespace PlankTests
 		assert (pixbuf_equal (surface.to_pixbuf (), surface2.to_pixbuf ()));
 	}
 	
+	void drawing_docksurface_blur_uniform ()
+	{
+		Surface surface, surface2;
+		
+		surface = new Surface (512, 512);
+		unowned Cairo.Context cr = surface.Context;
+		cr.set_source_rgba (0.2, 0.4, 0.6, 0.8);
+		cr.paint ();
+		
+		surface2 = surface.copy ();
+		
+		// A uniform surface has to stay untouched across all tiles
+		surface.fast_blur (7, 3);
+		assert (pixbuf_equal (surface.to_pixbuf (), surface2.to_pixbuf ()));
+		
+		surface.gaussian_blur (31);
+		assert (pixbuf_equal (surface.to_pixbuf (), surface2.to_pixbuf ()));
+		
+		surface.exponential_blur (15);
+		assert (pixbuf_equal (surface.to_pixbuf (), surface2.to_pixbuf ()));
+	}
+	
 	void drawing_docksurface_to_pixbuf ()
 	{
 		Surface surface, surface2;
@@ -414,6 +440,108 @@ namespace PlankTests
 		assert (pixbuf_equal (surface.to_pixbuf (), surface2.to_pixbuf ()));
 	}
 	
+	void drawing_surfacecache ()
+	{
+		SurfaceCache<Object> cache;
+		Surface model, surface, surface2;
+		int draw_count = 0;
+		
+		model = new Surface (1, 1);
+		cache = new SurfaceCache<Object> (SurfaceCacheFlags.NONE);
+		
+		DrawFunc<Object> draw_func = (w, h, m, f) => {
+			draw_count++;
+			return new Surface.with_surface (w, h, m);
+		};
+		
+		surface = cache.get_surface<Object> (64, 64, model, draw_func, null);
+		surface2 = cache.get_surface<Object> (64, 64, model, draw_func, null);
+		assert (surface == surface2);
+		assert (draw_count == 1);
+		
+		surface2 = cache.get_surface<Object> (32, 32, model, draw_func, null);
+		assert (surface != surface2);
+		assert (surface2.Width == 32);
+		assert (draw_count == 2);
+		
+		surface2 = cache.get_surface<Object> (64, 64, model, draw_func, null);
+		assert (surface == surface2);
+		assert (draw_count == 2);
+		
+		cache.clear ();
+		surface2 = cache.get_surface<Object> (64, 64, model, draw_func, null);
+		assert (surface != surface2);
+		assert (draw_count == 3);
+	}
+	
+	void drawing_surfacecache_budget ()
+	{
+		// Surfaces of the same size in bytes, differing by their dimensions
+		const int SURFACE_BYTES = 64 * 64 * 4;
+		const ulong ACCESS_INTERVAL = 100 * 1000;
+		
+		SurfaceCache<Object> cache, cache2;
+		Surface model, surface;
+		int draw_count = 0;
+		
+		unowned SurfaceCacheBudget budget = SurfaceCacheBudget.get_default ();
+		assert (budget.budget == 64 * 1024 * 1024);
+		
+		// Evict whatever other tests left behind, the current surfaces of caches are kept
+		budget.budget = 0;
+		var base_bytes = budget.get_stats ().get ("bytes").get_int64 ();
+		budget.budget = base_bytes + 3 * SURFACE_BYTES;
+		
+		model = new Surface (1, 1);
+		cache = new SurfaceCache<Object> (SurfaceCacheFlags.NONE);
+		cache2 = new SurfaceCache<Object> (SurfaceCacheFlags.NONE);
+		
+		// Equal drawing-times, so only the idle-time decides
+		DrawFunc<Object> draw_func = (w, h, m, f) => {
+			draw_count++;
+			Thread.usleep (2000);
+			return new Surface.with_surface (w, h, m);
+		};
+		
+		cache.get_surface<Object> (64, 64, model, draw_func, null);
+		Thread.usleep (ACCESS_INTERVAL);
+		cache.get_surface<Object> (32, 128, model, draw_func, null);
+		Thread.usleep (ACCESS_INTERVAL);
+		cache.get_surface<Object> (128, 32, model, draw_func, null);
+		Thread.usleep (ACCESS_INTERVAL);
+		assert (draw_count == 3);
+		
+		// A hit makes 64x64 the most recently used one, 32x128 is the least recently used now
+		cache.get_surface<Object> (64, 64, model, draw_func, null);
+		assert (draw_count == 3);
+		Thread.usleep (ACCESS_INTERVAL);
+		
+		var evictions = budget.get_stats ().get ("evictions").get_uint64 ();
+		cache2.get_surface<Object> (64, 64, model, draw_func, null);
+		assert (draw_count == 4);
+		assert (budget.get_stats ().get ("evictions").get_uint64 () == evictions + 1);
+		assert (budget.get_stats ().get ("bytes").get_int64 () <= budget.budget);
+		
+		// 128x32 survived
+		cache.get_surface<Object> (128, 32, model, draw_func, null);
+		assert (draw_count == 4);
+		
+		// 32x128 was evicted and is rendered again, which evicts 64x64 in turn
+		surface = cache.get_surface<Object> (32, 128, model, draw_func, null);
+		assert (draw_count == 5);
+		assert (surface.Width == 32 && surface.Height == 128);
+		assert (budget.get_stats ().get ("evictions").get_uint64 () == evictions + 2);
+		
+		cache.get_surface<Object> (128, 32, model, draw_func, null);
+		assert (draw_count == 5);
+		cache.get_surface<Object> (64, 64, model, draw_func, null);
+		assert (draw_count == 6);
+		
+		cache.clear ();
+		cache2.clear ();
+		budget.budget = 64 * 1024 * 1024;
+	}
+	
 	void drawing_easing ()
 	{
 		for (int i = AnimationMode.LINEAR; i < AnimationMode.LAST; i++)